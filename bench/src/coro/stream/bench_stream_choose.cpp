@@ -0,0 +1,62 @@
+// Copyright 2024 by Mark Melton
+//
+
+#include <benchmark/benchmark.h>
+#include "coro/stream/stream.h"
+
+using namespace coro;
+
+static constexpr size_t NumberElements = 1 << 20;
+
+// Return `k` sources that together yield NumberElements elements.
+static std::vector<Generator<const int64_t&>> sources(size_t k) {
+    std::vector<Generator<const int64_t&>> result;
+    for (size_t i = 0; i < k; ++i)
+	result.push_back(repeat<int64_t>(i, NumberElements / k));
+    return result;
+}
+
+// Choose uniformly among `state.range(0)` sources until all are
+// exhausted.
+static void BM_Choose(benchmark::State& state) {
+    for (auto _ : state) {
+	int64_t sum{0};
+	for (auto n : sources(state.range(0)) | choose())
+	    sum += n;
+	benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * NumberElements);
+}
+BENCHMARK(BM_Choose)->RangeMultiplier(16)->Range(2, 1 << 12);
+
+// Choose among `state.range(0)` sources weighted 1/(i+1) until all
+// are exhausted, so that the light sources drain last.
+static void BM_ChooseWeighted(benchmark::State& state) {
+    std::vector<double> weights(state.range(0));
+    for (size_t i = 0; i < weights.size(); ++i)
+	weights[i] = 1.0 / (i + 1);
+    for (auto _ : state) {
+	int64_t sum{0};
+	for (auto n : sources(state.range(0)) | choose(weights))
+	    sum += n;
+	benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * NumberElements);
+}
+BENCHMARK(BM_ChooseWeighted)->RangeMultiplier(16)->Range(2, 1 << 12);
+
+// A 90/9/1 mix of three unbounded streams.
+static void BM_ChooseMix(benchmark::State& state) {
+    for (auto _ : state) {
+	int64_t sum{0};
+	for (auto n : repeat<int64_t>(0) * repeat<int64_t>(1) * repeat<int64_t>(2)
+		 | choose({90, 9, 1})
+		 | take(NumberElements))
+	    sum += n;
+	benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * NumberElements);
+}
+BENCHMARK(BM_ChooseMix);
+
+BENCHMARK_MAIN();
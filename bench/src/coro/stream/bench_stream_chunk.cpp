@@ -0,0 +1,51 @@
+// Copyright 2024 by Mark Melton
+//
+
+#include <benchmark/benchmark.h>
+#include "coro/stream/stream.h"
+
+using namespace coro;
+
+static constexpr size_t NumberElements = 1 << 20;
+
+// iota -> transform -> reduce resuming each stage once per element.
+static void BM_PerElement(benchmark::State& state) {
+    for (auto _ : state) {
+	auto sum = iota<int64_t>(NumberElements)
+	    | transform([](int64_t n) { return 3 * n + 1; })
+	    | reduce(int64_t{0}, [](int64_t& acc, int64_t n) { acc += n; });
+	benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * NumberElements);
+}
+BENCHMARK(BM_PerElement);
+
+// iota -> transform -> reduce resuming each stage once per chunk of
+// `state.range(0)` elements.
+static void BM_PerChunk(benchmark::State& state) {
+    size_t size = state.range(0);
+    for (auto _ : state) {
+	auto sum = chunk::iota<int64_t>(NumberElements, 0, 1, size)
+	    | chunk::transform([](int64_t n) { return 3 * n + 1; })
+	    | chunk::reduce(int64_t{0}, [](int64_t& acc, int64_t n) { acc += n; });
+	benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * NumberElements);
+}
+BENCHMARK(BM_PerChunk)->Arg(256)->Arg(1024)->Arg(4096);
+
+// Per-element source batched by the chunked() adaptor.
+static void BM_Chunked(benchmark::State& state) {
+    size_t size = state.range(0);
+    for (auto _ : state) {
+	auto sum = iota<int64_t>(NumberElements)
+	    | chunked(size)
+	    | chunk::transform([](int64_t n) { return 3 * n + 1; })
+	    | chunk::reduce(int64_t{0}, [](int64_t& acc, int64_t n) { acc += n; });
+	benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * NumberElements);
+}
+BENCHMARK(BM_Chunked)->Arg(256)->Arg(4096);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,107 @@
+// Copyright 2024 by Mark Melton
+//
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <benchmark/benchmark.h>
+#include "coro/stream/stream.h"
+
+using namespace coro;
+
+// Count every heap allocation so that the benchmarks can report
+// allocations per collected stream.
+static std::atomic<size_t> gs_allocations{0};
+
+void *operator new(std::size_t size) {
+    gs_allocations.fetch_add(1, std::memory_order_relaxed);
+    if (auto ptr = std::malloc(size))
+	return ptr;
+    throw std::bad_alloc{};
+}
+
+void operator delete(void *ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void *ptr, std::size_t) noexcept {
+    std::free(ptr);
+}
+
+static constexpr size_t NumberElements = 1 << 16;
+
+// Forward the elements of `source` dropping its size hint.
+template<Stream S>
+Generator<stream_yield_t<S>> unhinted(S source) {
+    for (auto&& elem : source)
+	co_yield elem;
+    co_return;
+}
+
+template<class F>
+static void run(benchmark::State& state, F func) {
+    size_t allocations{0};
+    for (auto _ : state) {
+	auto before = gs_allocations.load(std::memory_order_relaxed);
+	auto vec = func();
+	allocations += gs_allocations.load(std::memory_order_relaxed) - before;
+	benchmark::DoNotOptimize(vec.data());
+    }
+    state.counters["allocs"] = benchmark::Counter(allocations, benchmark::Counter::kAvgIterations);
+    state.SetItemsProcessed(state.iterations() * NumberElements);
+}
+
+// Collect integers into a vector reserved from the size hint.
+static void BM_CollectHinted(benchmark::State& state) {
+    run(state, []() {
+	return iota<int64_t>(NumberElements)
+	    | transform([](int64_t n) { return 3 * n; })
+	    | collect<std::vector>();
+    });
+}
+BENCHMARK(BM_CollectHinted);
+
+// Collect integers into a vector grown geometrically.
+static void BM_CollectUnhinted(benchmark::State& state) {
+    run(state, []() {
+	return unhinted(iota<int64_t>(NumberElements)
+			| transform([](int64_t n) { return 3 * n; }))
+	    | collect<std::vector>();
+    });
+}
+BENCHMARK(BM_CollectUnhinted);
+
+// Collect strings moved out of an rvalue-yielding transform.
+static void BM_CollectStringsMoved(benchmark::State& state) {
+    run(state, []() {
+	return iota<int64_t>(NumberElements)
+	    | transform([](int64_t n) { return std::string(32, 'a' + n % 26); })
+	    | collect<std::vector>();
+    });
+}
+BENCHMARK(BM_CollectStringsMoved);
+
+// Collect strings copied from the transform as before.
+static void BM_CollectStringsCopied(benchmark::State& state) {
+    run(state, []() {
+	auto strings = iota<int64_t>(NumberElements)
+	    | transform([](int64_t n) { return std::string(32, 'a' + n % 26); });
+	std::vector<std::string> vec;
+	for (auto&& s : strings)
+	    vec.push_back(s);
+	return vec;
+    });
+}
+BENCHMARK(BM_CollectStringsCopied);
+
+// Flatten vectors moved out of group.
+static void BM_Flatten(benchmark::State& state) {
+    run(state, []() {
+	return iota<int64_t>(NumberElements)
+	    | group(64)
+	    | flatten<std::vector<int64_t>>();
+    });
+}
+BENCHMARK(BM_Flatten);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,124 @@
+// Copyright 2024 by Mark Melton
+//
+
+#include <numeric>
+#include <random>
+#include <benchmark/benchmark.h>
+#include "coro/stream/stream.h"
+
+using namespace coro;
+
+static constexpr size_t NumberValues = 1 << 16;
+static constexpr uint64_t ZipfN = 1 << 16;
+
+// Fill a buffer with `sample_fill` from the distribution made by `make`.
+template<class T, class F>
+static void fill(benchmark::State& state, F make) {
+    std::vector<T> values(NumberValues);
+    auto dist = make();
+    for (auto _ : state) {
+	sample_fill<T>(std::span{values}, dist);
+	benchmark::DoNotOptimize(values.data());
+    }
+    state.SetItemsProcessed(state.iterations() * NumberValues);
+}
+
+// Fill a buffer from the distribution made by `make` with `std::mt19937_64`.
+template<class T, class F>
+static void fill_std(benchmark::State& state, F make) {
+    std::vector<T> values(NumberValues);
+    std::mt19937_64 engine;
+    auto dist = make();
+    for (auto _ : state) {
+	for (auto& value : values)
+	    value = dist(engine);
+	benchmark::DoNotOptimize(values.data());
+    }
+    state.SetItemsProcessed(state.iterations() * NumberValues);
+}
+
+static void BM_Normal(benchmark::State& state) {
+    fill<double>(state, []() { return dist::Normal{}; });
+}
+BENCHMARK(BM_Normal);
+
+static void BM_NormalStd(benchmark::State& state) {
+    fill_std<double>(state, []() { return std::normal_distribution<double>{}; });
+}
+BENCHMARK(BM_NormalStd);
+
+static void BM_Exponential(benchmark::State& state) {
+    fill<double>(state, []() { return dist::Exponential{}; });
+}
+BENCHMARK(BM_Exponential);
+
+static void BM_ExponentialStd(benchmark::State& state) {
+    fill_std<double>(state, []() { return std::exponential_distribution<double>{}; });
+}
+BENCHMARK(BM_ExponentialStd);
+
+static void BM_Poisson(benchmark::State& state) {
+    fill<uint64_t>(state, [&]() { return dist::Poisson(state.range(0)); });
+}
+BENCHMARK(BM_Poisson)->Arg(4)->Arg(100);
+
+static void BM_PoissonStd(benchmark::State& state) {
+    fill_std<uint64_t>(state, [&]() { return std::poisson_distribution<uint64_t>(state.range(0)); });
+}
+BENCHMARK(BM_PoissonStd)->Arg(4)->Arg(100);
+
+// The standard library has no Zipf distribution, so the baseline is a
+// discrete distribution over the ranks.
+static void BM_Zipf(benchmark::State& state) {
+    fill<uint64_t>(state, []() { return dist::Zipf{ZipfN, 1.1}; });
+}
+BENCHMARK(BM_Zipf);
+
+static void BM_ZipfStd(benchmark::State& state) {
+    fill_std<uint64_t>(state, []() {
+	std::vector<double> weights(ZipfN);
+	for (size_t k = 0; k < ZipfN; ++k)
+	    weights[k] = std::pow(k + 1, -1.1);
+	return std::discrete_distribution<uint64_t>(weights.begin(), weights.end());
+    });
+}
+BENCHMARK(BM_ZipfStd);
+
+static std::vector<double> histogram(size_t n) {
+    std::vector<double> weights(n);
+    for (size_t i = 0; i < n; ++i)
+	weights[i] = 1 + (i * 7919) % 101;
+    return weights;
+}
+
+static void BM_Empirical(benchmark::State& state) {
+    fill<double>(state, [&]() {
+	auto weights = histogram(state.range(0));
+	std::vector<double> values(weights.size());
+	std::iota(values.begin(), values.end(), 0.0);
+	return dist::Empirical{values, weights};
+    });
+}
+BENCHMARK(BM_Empirical)->Arg(16)->Arg(1 << 16);
+
+static void BM_EmpiricalStd(benchmark::State& state) {
+    fill_std<double>(state, [&]() {
+	auto weights = histogram(state.range(0));
+	return std::discrete_distribution<uint64_t>(weights.begin(), weights.end());
+    });
+}
+BENCHMARK(BM_EmpiricalStd)->Arg(16)->Arg(1 << 16);
+
+// One value per resume of a distribution sampler.
+static void BM_NormalSampler(benchmark::State& state) {
+    for (auto _ : state) {
+	double acc{0};
+	for (auto x : sampler<double>(dist::Normal{}) | take(NumberValues))
+	    acc += x;
+	benchmark::DoNotOptimize(acc);
+    }
+    state.SetItemsProcessed(state.iterations() * NumberValues);
+}
+BENCHMARK(BM_NormalSampler);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,75 @@
+// Copyright 2024 by Mark Melton
+//
+
+#include <benchmark/benchmark.h>
+#include <random>
+#include "coro/stream/stream.h"
+
+using namespace coro;
+
+static constexpr size_t NumberSamples = 1 << 20;
+
+// Raw engine throughput.
+template<class E>
+static void BM_Engine(benchmark::State& state) {
+    E engine;
+    for (auto _ : state) {
+	uint64_t acc{0};
+	for (size_t i = 0; i < NumberSamples; ++i)
+	    acc += engine();
+	benchmark::DoNotOptimize(acc);
+    }
+    state.SetItemsProcessed(state.iterations() * NumberSamples);
+}
+BENCHMARK(BM_Engine<std::mt19937>);
+BENCHMARK(BM_Engine<std::mt19937_64>);
+BENCHMARK(BM_Engine<SplitMix64>);
+BENCHMARK(BM_Engine<Xoshiro256ss>);
+BENCHMARK(BM_Engine<Pcg64>);
+BENCHMARK(BM_Engine<Philox4x64>);
+
+// The body of `sampler<uint64_t>()` with a thread-local engine `E`,
+// so every engine can be compared without rebuilding the library.
+template<class E>
+static E& bench_engine() {
+    thread_local E engine;
+    return engine;
+}
+
+template<class E>
+static Generator<uint64_t> engine_sampler() {
+    std::uniform_int_distribution<uint64_t> dist;
+    while (true)
+	co_yield dist(bench_engine<E>());
+    co_return;
+}
+
+template<class E>
+static void BM_EngineSampler(benchmark::State& state) {
+    for (auto _ : state) {
+	uint64_t acc{0};
+	for (auto n : engine_sampler<E>() | take(NumberSamples))
+	    acc += n;
+	benchmark::DoNotOptimize(acc);
+    }
+    state.SetItemsProcessed(state.iterations() * NumberSamples);
+}
+BENCHMARK(BM_EngineSampler<std::mt19937>);
+BENCHMARK(BM_EngineSampler<SplitMix64>);
+BENCHMARK(BM_EngineSampler<Xoshiro256ss>);
+BENCHMARK(BM_EngineSampler<Pcg64>);
+BENCHMARK(BM_EngineSampler<Philox4x64>);
+
+// `sampler<uint64_t>()` with the engine configured by STREAM_ENGINE.
+static void BM_Sampler(benchmark::State& state) {
+    for (auto _ : state) {
+	uint64_t acc{0};
+	for (auto n : sampler<uint64_t>() | take(NumberSamples))
+	    acc += n;
+	benchmark::DoNotOptimize(acc);
+    }
+    state.SetItemsProcessed(state.iterations() * NumberSamples);
+}
+BENCHMARK(BM_Sampler);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,57 @@
+// Copyright 2024 by Mark Melton
+//
+
+#include <benchmark/benchmark.h>
+#include "coro/stream/stream.h"
+
+using namespace coro;
+
+static constexpr size_t NumberValues = 1 << 20;
+
+// One value per resume of `sampler<T>(min, max)`.
+template<class T>
+static void BM_SamplerPerValue(benchmark::State& state) {
+    for (auto _ : state) {
+	T acc{0};
+	for (auto x : sampler<T>(T(0), T(1000)) | take(NumberValues))
+	    acc += x;
+	benchmark::DoNotOptimize(acc);
+    }
+    state.SetItemsProcessed(state.iterations() * NumberValues);
+}
+BENCHMARK(BM_SamplerPerValue<uint32_t>);
+BENCHMARK(BM_SamplerPerValue<uint64_t>);
+BENCHMARK(BM_SamplerPerValue<double>);
+
+// `Sampler<T>::fill` over a buffer of `NumberValues`.
+template<class T>
+static void BM_SamplerFill(benchmark::State& state) {
+    std::vector<T> values(NumberValues);
+    for (auto _ : state) {
+	Sampler<T>{}.fill(values, T(0), T(1000));
+	benchmark::DoNotOptimize(values.data());
+    }
+    state.SetItemsProcessed(state.iterations() * NumberValues);
+}
+BENCHMARK(BM_SamplerFill<uint32_t>);
+BENCHMARK(BM_SamplerFill<uint64_t>);
+BENCHMARK(BM_SamplerFill<float>);
+BENCHMARK(BM_SamplerFill<double>);
+
+// `chunk::sampler<T>` in chunks of `state.range(0)` values.
+template<class T>
+static void BM_SamplerChunked(benchmark::State& state) {
+    size_t size = state.range(0);
+    for (auto _ : state) {
+	T acc{0};
+	for (auto chunk : chunk::sampler<T>(size, T(0), T(1000)) | take(NumberValues / size))
+	    for (auto x : chunk)
+		acc += x;
+	benchmark::DoNotOptimize(acc);
+    }
+    state.SetItemsProcessed(state.iterations() * NumberValues);
+}
+BENCHMARK(BM_SamplerChunked<uint64_t>)->Arg(256)->Arg(4096);
+BENCHMARK(BM_SamplerChunked<double>)->Arg(256)->Arg(4096);
+
+BENCHMARK_MAIN();
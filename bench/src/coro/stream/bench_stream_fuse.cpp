@@ -0,0 +1,68 @@
+// Copyright 2024 by Mark Melton
+//
+
+#include <benchmark/benchmark.h>
+#include "coro/stream/stream.h"
+
+using namespace coro;
+
+static constexpr size_t NumberElements = 1 << 20;
+
+// Only odd `n` pass `even(scale(n))`, so taking `NumberElements / 4`
+// stops after the first `NumberConsumed` source elements.
+static constexpr size_t NumberConsumed = NumberElements / 2;
+
+static auto scale = [](int64_t n) { return 3 * n + 1; };
+static auto even = [](int64_t n) { return n % 2 == 0; };
+static auto half = [](int64_t n) { return n / 2; };
+static auto sum = [](int64_t& acc, int64_t n) { acc += n; };
+
+// iota -> transform -> filter -> transform -> take -> reduce with each
+// stage a separate coroutine.
+static void BM_Nested(benchmark::State& state) {
+    for (auto _ : state) {
+	auto total = iota<int64_t>(NumberElements)
+	    | transform(scale)
+	    | filter(even)
+	    | transform(half)
+	    | take(NumberElements / 4)
+	    | reduce(int64_t{0}, sum);
+	benchmark::DoNotOptimize(total);
+    }
+    state.SetItemsProcessed(state.iterations() * NumberConsumed);
+}
+BENCHMARK(BM_Nested);
+
+// The same chain with the stages fused into a single loop.
+static void BM_Fused(benchmark::State& state) {
+    for (auto _ : state) {
+	auto total = iota<int64_t>(NumberElements)
+	    | fuse::transform(scale)
+	    | fuse::filter(even)
+	    | fuse::transform(half)
+	    | fuse::take(NumberElements / 4)
+	    | reduce(int64_t{0}, sum);
+	benchmark::DoNotOptimize(total);
+    }
+    state.SetItemsProcessed(state.iterations() * NumberConsumed);
+}
+BENCHMARK(BM_Fused);
+
+// The fused stages materialized as one generator and consumed by an
+// unfused reduce.
+static void BM_FusedGenerator(benchmark::State& state) {
+    for (auto _ : state) {
+	int64_t total{0};
+	for (auto n : iota<int64_t>(NumberElements)
+		 | fuse::transform(scale)
+		 | fuse::filter(even)
+		 | fuse::transform(half)
+		 | fuse::take(NumberElements / 4))
+	    total += n;
+	benchmark::DoNotOptimize(total);
+    }
+    state.SetItemsProcessed(state.iterations() * NumberConsumed);
+}
+BENCHMARK(BM_FusedGenerator);
+
+BENCHMARK_MAIN();
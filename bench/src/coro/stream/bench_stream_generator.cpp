@@ -0,0 +1,204 @@
+// Copyright 2024 by Mark Melton
+//
+
+#include <benchmark/benchmark.h>
+#include <cstdlib>
+#include <memory>
+#include "coro/stream/stream.h"
+
+using namespace coro;
+
+// Count every call to the global allocator so that the benchmarks
+// can report allocations per chain. Configure with
+// `-DSTREAM_FRAME_POOL=OFF` to measure the unpooled baseline.
+static size_t gs_allocations{0};
+
+void *operator new(std::size_t size) {
+    ++gs_allocations;
+    if (auto ptr = std::malloc(size))
+	return ptr;
+    throw std::bad_alloc{};
+}
+
+void operator delete(void *ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void *ptr, std::size_t) noexcept {
+    std::free(ptr);
+}
+
+Generator<int> counter(int n) {
+    for (auto i = 0; i < n; ++i)
+	co_yield i;
+}
+
+Generator<int> counter(std::allocator_arg_t, std::allocator<std::byte>, int n) {
+    for (auto i = 0; i < n; ++i)
+	co_yield i;
+}
+
+// Create and drain a single generator frame from the frame pool.
+static void BM_FramePooled(benchmark::State& state) {
+    auto start = gs_allocations;
+    for (auto _ : state) {
+	for (auto n : counter(1))
+	    benchmark::DoNotOptimize(n);
+    }
+    state.counters["allocs"] = benchmark::Counter(gs_allocations - start,
+						  benchmark::Counter::kAvgIterations);
+}
+BENCHMARK(BM_FramePooled);
+
+// Create and drain a single generator frame from the global allocator.
+static void BM_FrameGlobal(benchmark::State& state) {
+    auto start = gs_allocations;
+    for (auto _ : state) {
+	for (auto n : counter(std::allocator_arg, std::allocator<std::byte>{}, 1))
+	    benchmark::DoNotOptimize(n);
+    }
+    state.counters["allocs"] = benchmark::Counter(gs_allocations - start,
+						  benchmark::Counter::kAvgIterations);
+}
+BENCHMARK(BM_FrameGlobal);
+
+// Create and drain a single generator frame from a scoped buffer.
+static void BM_FrameScoped(benchmark::State& state) {
+    auto start = gs_allocations;
+    ScopedFrames<1024> frames;
+    for (auto _ : state) {
+	for (auto n : counter(1))
+	    benchmark::DoNotOptimize(n);
+    }
+    state.counters["allocs"] = benchmark::Counter(gs_allocations - start,
+						  benchmark::Counter::kAvgIterations);
+}
+BENCHMARK(BM_FrameScoped);
+
+// A generator whose frame is too large for the frame pool.
+Generator<int> large_frame(int n) {
+    int buffer[512];
+    for (auto i = 0; i < n; ++i) {
+	buffer[i % 512] = i;
+	benchmark::DoNotOptimize(buffer);
+	co_yield buffer[i % 512];
+    }
+}
+
+// Create and drain a large frame from the pool (0) or a scoped buffer (1).
+static void BM_LargeFrame(benchmark::State& state) {
+    auto start = gs_allocations;
+    for (auto _ : state) {
+	if (state.range(0)) {
+	    auto sum = scoped<4096>([]() { return large_frame(1) | reduce(0, [](int& a, int n) { a += n; }); });
+	    benchmark::DoNotOptimize(sum);
+	} else {
+	    auto sum = large_frame(1) | reduce(0, [](int& a, int n) { a += n; });
+	    benchmark::DoNotOptimize(sum);
+	}
+    }
+    state.counters["allocs"] = benchmark::Counter(gs_allocations - start,
+						  benchmark::Counter::kAvgIterations);
+}
+BENCHMARK(BM_LargeFrame)->Arg(0)->Arg(1);
+
+// Build and drain a four stage chain yielding `state.range(0)` elements.
+static void BM_Chain(benchmark::State& state) {
+    auto count = state.range(0);
+    auto start = gs_allocations;
+    for (auto _ : state) {
+	auto g = sampler<int>(0, 100)
+	    | filter([](int n) { return n % 2 == 0; })
+	    | transform([](int n) { return n + 1; })
+	    | take(count);
+	for (auto n : g)
+	    benchmark::DoNotOptimize(n);
+    }
+    state.counters["allocs_per_chain"] = benchmark::Counter(gs_allocations - start,
+							    benchmark::Counter::kAvgIterations);
+    state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_Chain)->Arg(1)->Arg(16)->Arg(256);
+
+// The same chain with its frames in a scoped buffer.
+static void BM_ChainScoped(benchmark::State& state) {
+    auto count = state.range(0);
+    auto start = gs_allocations;
+    for (auto _ : state) {
+	scoped([&]() {
+	    auto g = sampler<int>(0, 100)
+		| filter([](int n) { return n % 2 == 0; })
+		| transform([](int n) { return n + 1; })
+		| take(count);
+	    for (auto n : g)
+		benchmark::DoNotOptimize(n);
+	});
+    }
+    state.counters["allocs_per_chain"] = benchmark::Counter(gs_allocations - start,
+							    benchmark::Counter::kAvgIterations);
+    state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_ChainScoped)->Arg(1)->Arg(16)->Arg(256);
+
+// Yield one element through `depth` recursively nested generators.
+Generator<int> nested(int depth) {
+    if (depth > 1)
+	co_yield nested(depth - 1);
+    else
+	co_yield depth;
+}
+
+// Yield `Count` elements each from a nest of `state.range(0)` generators.
+static void BM_RecursiveYield(benchmark::State& state) {
+    constexpr int Count = 64;
+    auto depth = state.range(0);
+    auto outer = [](int depth) -> Generator<int> {
+	for (auto i = 0; i < Count; ++i)
+	    co_yield nested(depth);
+    };
+    for (auto _ : state) {
+	for (auto n : outer(depth))
+	    benchmark::DoNotOptimize(n);
+    }
+    state.SetItemsProcessed(state.iterations() * Count);
+    state.counters["levels_per_second"] = benchmark::Counter(state.iterations() * Count * depth,
+							     benchmark::Counter::kIsRate);
+}
+BENCHMARK(BM_RecursiveYield)->RangeMultiplier(10)->Range(1, 10000);
+
+// Yield `state.range(0)` elements each from its own short nested generator.
+static void BM_NestedLoop(benchmark::State& state) {
+    auto count = state.range(0);
+    auto outer = [](int count) -> Generator<int> {
+	for (auto i = 0; i < count; ++i)
+	    co_yield nested(1);
+    };
+    for (auto _ : state) {
+	for (auto n : outer(count))
+	    benchmark::DoNotOptimize(n);
+    }
+    state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_NestedLoop)->Arg(1 << 16);
+
+// Yield the nodes of a complete binary tree with `state.range(0)`
+// levels in order, one generator per node.
+Generator<int> walk(int node, int levels) {
+    if (levels > 1)
+	co_yield walk(2 * node, levels - 1);
+    co_yield node;
+    if (levels > 1)
+	co_yield walk(2 * node + 1, levels - 1);
+}
+
+static void BM_TreeWalk(benchmark::State& state) {
+    auto levels = state.range(0);
+    for (auto _ : state) {
+	for (auto n : walk(1, levels))
+	    benchmark::DoNotOptimize(n);
+    }
+    state.SetItemsProcessed(state.iterations() * ((int64_t{1} << levels) - 1));
+}
+BENCHMARK(BM_TreeWalk)->Arg(10)->Arg(20);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,51 @@
+// Copyright 2024 by Mark Melton
+//
+
+#include <benchmark/benchmark.h>
+#include "coro/stream/stream.h"
+
+using namespace coro;
+
+static constexpr size_t NumberElements = 1 << 20;
+
+// Groups of `state.range(0)` elements yielded as vectors.
+static void BM_Group(benchmark::State& state) {
+    for (auto _ : state) {
+	int64_t sum{0};
+	for (auto&& vec : iota<int64_t>(NumberElements) | group(state.range(0)))
+	    for (auto n : vec)
+		sum += n;
+	benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * NumberElements);
+}
+BENCHMARK(BM_Group)->Arg(16)->Arg(1024);
+
+// Groups of `state.range(0)` elements yielded as spans of a reused buffer.
+static void BM_GroupSpan(benchmark::State& state) {
+    for (auto _ : state) {
+	int64_t sum{0};
+	for (auto span : iota<int64_t>(NumberElements) | group_span(state.range(0)))
+	    for (auto n : span)
+		sum += n;
+	benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * NumberElements);
+}
+BENCHMARK(BM_GroupSpan)->Arg(16)->Arg(1024);
+
+// Groups of at most `state.range(0)` bytes of strings.
+static void BM_GroupByBytes(benchmark::State& state) {
+    static auto lines = str::alpha(0, 64) | take(1 << 16) | collect<std::vector>();
+    auto size = [](const std::string& s) { return s.size(); };
+    for (auto _ : state) {
+	size_t groups{0};
+	for (auto span : lines | group_by_bytes(state.range(0), size))
+	    groups += span.size() > 0;
+	benchmark::DoNotOptimize(groups);
+    }
+    state.SetItemsProcessed(state.iterations() * lines.size());
+}
+BENCHMARK(BM_GroupByBytes)->Arg(1 << 12)->Arg(1 << 16);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,184 @@
+// Copyright 2024 by Mark Melton
+//
+
+#include <benchmark/benchmark.h>
+#include <cstdlib>
+#include <fcntl.h>
+#include <filesystem>
+#include <fstream>
+#include <unistd.h>
+#include "coro/stream/stream.h"
+
+using namespace coro;
+namespace fs = std::filesystem;
+
+// A file of random lines generated once for all the benchmarks. Its
+// size in megabytes is taken from STREAM_BENCH_FILE_MB (default 1024).
+class LinesFile {
+public:
+    LinesFile()
+	: path_(fs::temp_directory_path() / ("stream-bench." + std::to_string(getpid()))) {
+	size_t megabytes{1024};
+	if (auto env = std::getenv("STREAM_BENCH_FILE_MB"))
+	    megabytes = std::strtoul(env, nullptr, 10);
+
+	std::ofstream ofs{path_};
+	for (auto line : str::alphanum(0, 120)) {
+	    ofs << line << '\n';
+	    size_ += line.size() + 1;
+	    if (size_ >= (megabytes << 20))
+		break;
+	}
+    }
+
+    ~LinesFile() {
+	fs::remove(path_);
+    }
+
+    std::string path() const { return path_.string(); }
+    size_t size() const { return size_; }
+
+private:
+    fs::path path_;
+    size_t size_{0};
+};
+
+static const LinesFile& lines_file() {
+    static LinesFile file;
+    return file;
+}
+
+static void BM_ReadLinesPlain(benchmark::State& state) {
+    const auto& file = lines_file();
+    auto path = file.path();
+    for (auto _ : state) {
+	size_t bytes{0};
+	for (const auto& line : read_lines_plain(path))
+	    bytes += line.size() + 1;
+	benchmark::DoNotOptimize(bytes);
+    }
+    state.SetBytesProcessed(state.iterations() * file.size());
+}
+BENCHMARK(BM_ReadLinesPlain)->Unit(benchmark::kMillisecond);
+
+static void BM_ReadLinesMmap(benchmark::State& state) {
+    const auto& file = lines_file();
+    auto path = file.path();
+    for (auto _ : state) {
+	size_t bytes{0};
+	for (auto line : read_lines_mmap(path))
+	    bytes += line.size() + 1;
+	benchmark::DoNotOptimize(bytes);
+    }
+    state.SetBytesProcessed(state.iterations() * file.size());
+}
+BENCHMARK(BM_ReadLinesMmap)->Unit(benchmark::kMillisecond);
+
+// Asynchronous block reads through io_uring (`state.range(0)` is 1)
+// or the pread thread (`state.range(0)` is 0).
+static void BM_ReadLinesUring(benchmark::State& state) {
+    const auto& file = lines_file();
+    auto path = file.path();
+    AsyncOptions options{.uring = state.range(0) != 0};
+    for (auto _ : state) {
+	size_t bytes{0};
+	for (auto line : read_lines_uring(path, options))
+	    bytes += line.size() + 1;
+	benchmark::DoNotOptimize(bytes);
+    }
+    state.SetBytesProcessed(state.iterations() * file.size());
+}
+BENCHMARK(BM_ReadLinesUring)->Arg(0)->Arg(1)->Unit(benchmark::kMillisecond);
+
+// Evict the file from the page cache so the next read hits the device.
+static void drop_cache(const std::string& path) {
+    auto fd = ::open(path.c_str(), O_RDONLY);
+    if (fd >= 0) {
+	::fdatasync(fd);
+	::posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+	::close(fd);
+    }
+}
+
+// Cold cache reads with the plain (0), mmap (1) and io_uring (2) readers.
+static void BM_ReadLinesCold(benchmark::State& state) {
+    const auto& file = lines_file();
+    auto path = file.path();
+    for (auto _ : state) {
+	state.PauseTiming();
+	drop_cache(path);
+	state.ResumeTiming();
+	size_t bytes{0};
+	switch (state.range(0)) {
+	case 0:
+	    for (const auto& line : read_lines_plain(path))
+		bytes += line.size() + 1;
+	    break;
+	case 1:
+	    for (auto line : read_lines_mmap(path))
+		bytes += line.size() + 1;
+	    break;
+	default:
+	    for (auto line : read_lines_uring(path))
+		bytes += line.size() + 1;
+	    break;
+	}
+	benchmark::DoNotOptimize(bytes);
+    }
+    state.SetBytesProcessed(state.iterations() * file.size());
+}
+BENCHMARK(BM_ReadLinesCold)->DenseRange(0, 2)->Unit(benchmark::kMillisecond);
+
+// A fixed set of lines written by the write benchmarks.
+static const std::vector<std::string>& sample_lines() {
+    static auto lines = str::alphanum(0, 120) | take(1 << 18) | collect<std::vector>();
+    return lines;
+}
+
+static size_t sample_bytes() {
+    size_t bytes{0};
+    for (const auto& line : sample_lines())
+	bytes += line.size() + 1;
+    return bytes;
+}
+
+static std::string output_path() {
+    return (fs::temp_directory_path() / ("stream-bench-out." + std::to_string(getpid()))).string();
+}
+
+static void BM_WriteLinesPlain(benchmark::State& state) {
+    const auto& lines = sample_lines();
+    auto path = output_path();
+    for (auto _ : state)
+	write_lines_plain(adapt(lines), path);
+    fs::remove(path);
+    state.SetBytesProcessed(state.iterations() * sample_bytes());
+}
+BENCHMARK(BM_WriteLinesPlain)->Unit(benchmark::kMillisecond);
+
+// Buffered writes with a buffer of `state.range(0)` bytes.
+static void BM_WriteLinesFile(benchmark::State& state) {
+    const auto& lines = sample_lines();
+    auto path = output_path();
+    WriteStats stats;
+    for (auto _ : state)
+	stats = write_lines_file(adapt(lines), path, {.buffer_bytes = size_t(state.range(0))});
+    fs::remove(path);
+    state.SetBytesProcessed(state.iterations() * sample_bytes());
+    state.counters["flushes"] = stats.flushes;
+}
+BENCHMARK(BM_WriteLinesFile)->Arg(1 << 12)->Arg(1 << 16)->Arg(1 << 20)->Unit(benchmark::kMillisecond);
+
+// Asynchronous block writes through io_uring or the pwrite thread.
+static void BM_WriteLinesUring(benchmark::State& state) {
+    const auto& lines = sample_lines();
+    auto path = output_path();
+    AsyncOptions options{.uring = state.range(0) != 0};
+    for (auto _ : state)
+	write_lines_uring(adapt(lines), path, options);
+    fs::remove(path);
+    state.SetBytesProcessed(state.iterations() * sample_bytes());
+}
+BENCHMARK(BM_WriteLinesUring)->Arg(0)->Arg(1)->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,62 @@
+// Copyright 2024 by Mark Melton
+//
+
+#include <queue>
+#include <benchmark/benchmark.h>
+#include "coro/stream/stream.h"
+
+using namespace coro;
+
+static constexpr size_t NumberElements = 1 << 20;
+
+// Return `k` sorted streams that interleave 0..NumberElements-1.
+static std::vector<Generator<const int64_t&>> shards(size_t k) {
+    std::vector<Generator<const int64_t&>> sources;
+    for (size_t i = 0; i < k; ++i)
+	sources.push_back(iota<int64_t>(NumberElements / k, i, k));
+    return sources;
+}
+
+// Merge `state.range(0)` sorted streams with a loser tree.
+static void BM_Merge(benchmark::State& state) {
+    for (auto _ : state) {
+	int64_t sum{0};
+	for (auto n : shards(state.range(0)) | merge())
+	    sum += n;
+	benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * NumberElements);
+}
+BENCHMARK(BM_Merge)->Arg(2)->Arg(64)->Arg(1024);
+
+// Merge `state.range(0)` sorted streams with a binary heap.
+static void BM_MergeHeap(benchmark::State& state) {
+    for (auto _ : state) {
+	auto sources = shards(state.range(0));
+	using Iterator = decltype(sources.front().begin());
+	std::vector<Iterator> iters;
+	for (auto& source : sources)
+	    iters.push_back(source.begin());
+
+	auto after = [&](size_t a, size_t b) { return *iters[b] < *iters[a]; };
+	std::priority_queue<size_t, std::vector<size_t>, decltype(after)> heap{after};
+	for (size_t i = 0; i < iters.size(); ++i)
+	    if (iters[i] != sources[i].end())
+		heap.push(i);
+
+	int64_t sum{0};
+	while (not heap.empty()) {
+	    auto idx = heap.top();
+	    heap.pop();
+	    sum += *iters[idx];
+	    ++iters[idx];
+	    if (iters[idx] != sources[idx].end())
+		heap.push(idx);
+	}
+	benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * NumberElements);
+}
+BENCHMARK(BM_MergeHeap)->Arg(2)->Arg(64)->Arg(1024);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,203 @@
+// Copyright 2024 by Mark Melton
+//
+
+#include <benchmark/benchmark.h>
+#include "coro/stream/stream.h"
+
+using namespace coro;
+
+static constexpr size_t NumberElements = 1 << 20;
+
+// The input for the operators over a container.
+static const std::vector<int64_t>& numbers() {
+    static auto data = iota<int64_t>(NumberElements) | collect<std::vector>();
+    return data;
+}
+
+// Resume a generator once per element.
+static void BM_Resume(benchmark::State& state) {
+    for (auto _ : state) {
+	for (auto n : iota<int64_t>(NumberElements))
+	    benchmark::DoNotOptimize(n);
+    }
+    state.SetItemsProcessed(state.iterations() * NumberElements);
+    state.SetBytesProcessed(state.iterations() * NumberElements * sizeof(int64_t));
+}
+BENCHMARK(BM_Resume);
+
+// Resume a generator adapting a container.
+static void BM_Adapt(benchmark::State& state) {
+    for (auto _ : state) {
+	for (auto n : adapt(numbers()))
+	    benchmark::DoNotOptimize(n);
+    }
+    state.SetItemsProcessed(state.iterations() * NumberElements);
+    state.SetBytesProcessed(state.iterations() * NumberElements * sizeof(int64_t));
+}
+BENCHMARK(BM_Adapt);
+
+static void BM_Take(benchmark::State& state) {
+    for (auto _ : state) {
+	for (auto n : repeat(int64_t{1}) | take(NumberElements))
+	    benchmark::DoNotOptimize(n);
+    }
+    state.SetItemsProcessed(state.iterations() * NumberElements);
+    state.SetBytesProcessed(state.iterations() * NumberElements * sizeof(int64_t));
+}
+BENCHMARK(BM_Take);
+
+// Filter keeping one in `state.range(0)` elements.
+static void BM_Filter(benchmark::State& state) {
+    auto modulus = state.range(0);
+    for (auto _ : state) {
+	for (auto n : numbers() | filter([=](int64_t n) { return n % modulus == 0; }))
+	    benchmark::DoNotOptimize(n);
+    }
+    state.SetItemsProcessed(state.iterations() * NumberElements);
+    state.SetBytesProcessed(state.iterations() * NumberElements * sizeof(int64_t));
+}
+BENCHMARK(BM_Filter)->Arg(1)->Arg(2)->Arg(16);
+
+static void BM_Transform(benchmark::State& state) {
+    for (auto _ : state) {
+	for (auto n : numbers() | transform([](int64_t n) { return 3 * n + 1; }))
+	    benchmark::DoNotOptimize(n);
+    }
+    state.SetItemsProcessed(state.iterations() * NumberElements);
+    state.SetBytesProcessed(state.iterations() * NumberElements * sizeof(int64_t));
+}
+BENCHMARK(BM_Transform);
+
+// Zip `state.range(0)` containers (2 or 3).
+static void BM_Zip(benchmark::State& state) {
+    const auto& data = numbers();
+    for (auto _ : state) {
+	if (state.range(0) == 2) {
+	    for (auto&& tup : zip(data, data))
+		benchmark::DoNotOptimize(tup);
+	} else {
+	    for (auto&& tup : zip(data, data, data))
+		benchmark::DoNotOptimize(tup);
+	}
+    }
+    state.SetItemsProcessed(state.iterations() * NumberElements);
+    state.SetBytesProcessed(state.iterations() * NumberElements * state.range(0) * sizeof(int64_t));
+}
+BENCHMARK(BM_Zip)->Arg(2)->Arg(3);
+
+// Zip two containers through coroutines rather than an index loop.
+static void BM_ZipAdapted(benchmark::State& state) {
+    const auto& data = numbers();
+    for (auto _ : state) {
+	for (auto&& tup : adapt(data) * adapt(data) | zip())
+	    benchmark::DoNotOptimize(tup);
+    }
+    state.SetItemsProcessed(state.iterations() * NumberElements);
+    state.SetBytesProcessed(state.iterations() * NumberElements * 2 * sizeof(int64_t));
+}
+BENCHMARK(BM_ZipAdapted);
+
+// The dot product of two columns through zipped rows.
+static void BM_ZipDot(benchmark::State& state) {
+    const auto& data = numbers();
+    for (auto _ : state) {
+	int64_t sum{0};
+	for (auto&& [x, y] : zip(data, data))
+	    sum += x * y;
+	benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * NumberElements);
+    state.SetBytesProcessed(state.iterations() * NumberElements * 2 * sizeof(int64_t));
+}
+BENCHMARK(BM_ZipDot);
+
+// The dot product of two columns through batches of `state.range(0)`
+// rows viewed in place.
+static void BM_ZipColumnsDot(benchmark::State& state) {
+    const auto& data = numbers();
+    size_t batch = state.range(0);
+    for (auto _ : state) {
+	int64_t sum{0};
+	for (auto [x, y] : zip_columns(batch, data, data))
+	    for (size_t i = 0; i < x.size(); ++i)
+		sum += x[i] * y[i];
+	benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * NumberElements);
+    state.SetBytesProcessed(state.iterations() * NumberElements * 2 * sizeof(int64_t));
+}
+BENCHMARK(BM_ZipColumnsDot)->Arg(256)->Arg(4096);
+
+// The same with the columns produced by generators and buffered.
+static void BM_ZipColumnsBuffered(benchmark::State& state) {
+    size_t batch = state.range(0);
+    for (auto _ : state) {
+	int64_t sum{0};
+	for (auto [x, y] : iota<int64_t>(NumberElements) * iota<int64_t>(NumberElements) | zip_columns(batch))
+	    for (size_t i = 0; i < x.size(); ++i)
+		sum += x[i] * y[i];
+	benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * NumberElements);
+    state.SetBytesProcessed(state.iterations() * NumberElements * 2 * sizeof(int64_t));
+}
+BENCHMARK(BM_ZipColumnsBuffered)->Arg(4096);
+
+// Collect a container (0) or the same elements through a coroutine (1).
+static void BM_Collect(benchmark::State& state) {
+    for (auto _ : state) {
+	if (state.range(0)) {
+	    auto copy = adapt(numbers()) | collect<std::vector>();
+	    benchmark::DoNotOptimize(copy.data());
+	} else {
+	    auto copy = numbers() | collect<std::vector>();
+	    benchmark::DoNotOptimize(copy.data());
+	}
+    }
+    state.SetItemsProcessed(state.iterations() * NumberElements);
+    state.SetBytesProcessed(state.iterations() * NumberElements * sizeof(int64_t));
+}
+BENCHMARK(BM_Collect)->Arg(0)->Arg(1);
+
+// Group a container (0) or the same elements through a coroutine (1)
+// into vectors of 256.
+static void BM_Group(benchmark::State& state) {
+    for (auto _ : state) {
+	int64_t sum{0};
+	auto add = [&](const std::vector<int64_t>& group) { sum += group.back(); };
+	if (state.range(0))
+	    adapt(numbers()) | group(256) | apply(add);
+	else
+	    numbers() | group(256) | apply(add);
+	benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * NumberElements);
+    state.SetBytesProcessed(state.iterations() * NumberElements * sizeof(int64_t));
+}
+BENCHMARK(BM_Group)->Arg(0)->Arg(1);
+
+static void BM_Reduce(benchmark::State& state) {
+    for (auto _ : state) {
+	auto sum = numbers() | reduce(int64_t{0}, [](int64_t& acc, int64_t n) { acc += n; });
+	benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * NumberElements);
+    state.SetBytesProcessed(state.iterations() * NumberElements * sizeof(int64_t));
+}
+BENCHMARK(BM_Reduce);
+
+// The chain of filter, transform and reduce.
+static void BM_Chain(benchmark::State& state) {
+    for (auto _ : state) {
+	auto sum = numbers()
+	    | filter([](int64_t n) { return n % 2 == 0; })
+	    | transform([](int64_t n) { return 3 * n + 1; })
+	    | reduce(int64_t{0}, [](int64_t& acc, int64_t n) { acc += n; });
+	benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * NumberElements);
+    state.SetBytesProcessed(state.iterations() * NumberElements * sizeof(int64_t));
+}
+BENCHMARK(BM_Chain);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,69 @@
+// Copyright 2024 by Mark Melton
+//
+
+#include <benchmark/benchmark.h>
+#include <cstdlib>
+#include <thread>
+#include "coro/stream/stream.h"
+
+using namespace coro;
+
+// The number of elements reduced, taken from STREAM_BENCH_REDUCE_N
+// (default 1 << 30).
+static size_t number_elements() {
+    static size_t n = []() {
+	if (auto env = std::getenv("STREAM_BENCH_REDUCE_N"))
+	    return size_t(std::strtoull(env, nullptr, 10));
+	return size_t{1} << 30;
+    }();
+    return n;
+}
+
+// A 256 bucket histogram of hashed elements.
+using Histogram = std::vector<uint64_t>;
+
+static auto bucket = [](Histogram& h, int64_t n) { ++h[mix64(n) & 255]; };
+
+static auto combine = [](Histogram& h, Histogram&& other) {
+    for (size_t i = 0; i < h.size(); ++i)
+	h[i] += other[i];
+};
+
+static void BM_Reduce(benchmark::State& state) {
+    for (auto _ : state) {
+	auto h = iota<int64_t>(number_elements()) | reduce(Histogram(256), bucket);
+	benchmark::DoNotOptimize(h.data());
+    }
+    state.SetItemsProcessed(state.iterations() * number_elements());
+}
+BENCHMARK(BM_Reduce)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+static void BM_ParReduce(benchmark::State& state) {
+    for (auto _ : state) {
+	auto h = iota<int64_t>(number_elements())
+	    | par_reduce(Histogram(256), bucket, combine, state.range(0));
+	benchmark::DoNotOptimize(h.data());
+    }
+    state.SetItemsProcessed(state.iterations() * number_elements());
+}
+
+static void BM_ParReduceUnordered(benchmark::State& state) {
+    for (auto _ : state) {
+	auto h = iota<int64_t>(number_elements())
+	    | par_reduce_unordered(Histogram(256), bucket, combine, state.range(0));
+	benchmark::DoNotOptimize(h.data());
+    }
+    state.SetItemsProcessed(state.iterations() * number_elements());
+}
+
+static void thread_counts(benchmark::internal::Benchmark *b) {
+    auto max_threads = std::max<int>(std::thread::hardware_concurrency(), 1);
+    for (auto threads = 1; threads < max_threads; threads *= 2)
+	b->Arg(threads);
+    b->Arg(max_threads);
+}
+
+BENCHMARK(BM_ParReduce)->Apply(thread_counts)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK(BM_ParReduceUnordered)->Apply(thread_counts)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+BENCHMARK_MAIN();
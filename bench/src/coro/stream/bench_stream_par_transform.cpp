@@ -0,0 +1,61 @@
+// Copyright 2024 by Mark Melton
+//
+
+#include <benchmark/benchmark.h>
+#include <thread>
+#include "coro/stream/stream.h"
+
+using namespace coro;
+
+static constexpr size_t NumberElements = 1 << 14;
+
+// A deliberately CPU-heavy mapping standing in for parsing or hashing.
+static auto work = [](uint64_t n) {
+    for (auto i = 0; i < 2000; ++i)
+	n = n * 6364136223846793005ull + 1442695040888963407ull;
+    return n;
+};
+
+static void thread_counts(benchmark::internal::Benchmark *b) {
+    auto max_threads = std::max<int>(std::thread::hardware_concurrency(), 1);
+    for (auto threads = 1; threads < max_threads; threads *= 2)
+	b->Arg(threads);
+    b->Arg(max_threads);
+}
+
+static void BM_Transform(benchmark::State& state) {
+    for (auto _ : state) {
+	auto sum = iota<uint64_t>(NumberElements)
+	    | transform(work)
+	    | reduce(uint64_t{0}, [](uint64_t& acc, uint64_t n) { acc += n; });
+	benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * NumberElements);
+}
+BENCHMARK(BM_Transform)->UseRealTime();
+
+static void BM_ParTransform(benchmark::State& state) {
+    size_t threads = state.range(0);
+    for (auto _ : state) {
+	auto sum = iota<uint64_t>(NumberElements)
+	    | par_transform(work, threads, 16 * threads)
+	    | reduce(uint64_t{0}, [](uint64_t& acc, uint64_t n) { acc += n; });
+	benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * NumberElements);
+}
+BENCHMARK(BM_ParTransform)->Apply(thread_counts)->UseRealTime();
+
+static void BM_ParTransformUnordered(benchmark::State& state) {
+    size_t threads = state.range(0);
+    for (auto _ : state) {
+	auto sum = iota<uint64_t>(NumberElements)
+	    | par_transform_unordered(work, threads, 16 * threads)
+	    | reduce(uint64_t{0}, [](uint64_t& acc, uint64_t n) { acc += n; });
+	benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * NumberElements);
+}
+BENCHMARK(BM_ParTransformUnordered)->Apply(thread_counts)->UseRealTime();
+
+BENCHMARK_MAIN();
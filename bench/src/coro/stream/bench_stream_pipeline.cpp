@@ -0,0 +1,77 @@
+// Copyright 2024 by Mark Melton
+//
+
+#include <benchmark/benchmark.h>
+#include "coro/stream/stream.h"
+
+using namespace coro;
+
+static constexpr size_t NumberElements = 1 << 16;
+
+// A mapping costing about `rounds` multiplies per element.
+static auto work(int rounds) {
+    return [=](uint64_t n) {
+	for (auto i = 0; i < rounds; ++i)
+	    n = n * 6364136223846793005ull + 1442695040888963407ull;
+	return n;
+    };
+}
+
+// Producer and consumer each doing `state.range(0)` rounds of work on
+// one thread.
+static void BM_Inline(benchmark::State& state) {
+    auto rounds = state.range(0);
+    for (auto _ : state) {
+	auto sum = iota<uint64_t>(NumberElements)
+	    | transform(work(rounds))
+	    | reduce(uint64_t{0}, [=](uint64_t& acc, uint64_t n) { acc += work(rounds)(n); });
+	benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * NumberElements);
+    state.SetBytesProcessed(state.iterations() * NumberElements * sizeof(uint64_t));
+}
+BENCHMARK(BM_Inline)->Arg(0)->Arg(100)->UseRealTime();
+
+// The same split across a pipeline boundary for each wait strategy.
+static void BM_Pipeline(benchmark::State& state) {
+    auto rounds = state.range(0);
+    RingStats stats;
+    PipelineOptions options{.wait = WaitStrategy(state.range(1)), .stats = &stats};
+    for (auto _ : state) {
+	auto sum = iota<uint64_t>(NumberElements)
+	    | transform(work(rounds))
+	    | pipeline(options)
+	    | reduce(uint64_t{0}, [=](uint64_t& acc, uint64_t n) { acc += work(rounds)(n); });
+	benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * NumberElements);
+    state.SetBytesProcessed(state.iterations() * NumberElements * sizeof(uint64_t));
+    state.counters["full_waits"] = benchmark::Counter(stats.full_waits, benchmark::Counter::kAvgIterations);
+    state.counters["empty_waits"] = benchmark::Counter(stats.empty_waits, benchmark::Counter::kAvgIterations);
+}
+BENCHMARK(BM_Pipeline)
+->ArgsProduct({{0, 100}, {int(WaitStrategy::Spin), int(WaitStrategy::Yield), int(WaitStrategy::Block)}})
+->UseRealTime();
+
+// A producer whose cost is concentrated in every 256th element
+// feeding a steady consumer through a prefetch buffer of 4 elements,
+// fixed (0) or adaptive (1).
+static void BM_Prefetch(benchmark::State& state) {
+    auto adaptive = state.range(0) != 0;
+    PrefetchStats stats;
+    PrefetchOptions options{.capacity = 4, .adaptive = adaptive, .stats = &stats};
+    for (auto _ : state) {
+	auto sum = iota<uint64_t>(NumberElements)
+	    | transform([](uint64_t n) { return n % 256 == 0 ? work(25600)(n) : n; })
+	    | prefetch(options)
+	    | reduce(uint64_t{0}, [](uint64_t& acc, uint64_t n) { acc += work(100)(n); });
+	benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * NumberElements);
+    state.counters["full_waits"] = benchmark::Counter(stats.full_waits, benchmark::Counter::kAvgIterations);
+    state.counters["empty_waits"] = benchmark::Counter(stats.empty_waits, benchmark::Counter::kAvgIterations);
+    state.counters["limit"] = double(stats.limit);
+}
+BENCHMARK(BM_Prefetch)->Arg(0)->Arg(1)->UseRealTime();
+
+BENCHMARK_MAIN();
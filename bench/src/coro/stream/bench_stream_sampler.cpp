@@ -0,0 +1,78 @@
+// Copyright 2024 by Mark Melton
+//
+
+#include <benchmark/benchmark.h>
+#include <chrono>
+#include "coro/stream/stream.h"
+
+using namespace coro;
+
+static constexpr size_t NumberSamples = 1 << 16;
+
+// The bytes held by a sampled value including any owned by it.
+template<class T>
+size_t value_bytes(const T& value) {
+    if constexpr (requires { value.size(); typename T::value_type; })
+	return sizeof(T) + value.size() * sizeof(typename T::value_type);
+    else
+	return sizeof(T);
+}
+
+// Draw `NumberSamples` values per iteration from `make()`.
+template<class F>
+void draw_samples(benchmark::State& state, F make) {
+    size_t bytes{0};
+    for (auto _ : state) {
+	for (auto&& value : make() | take(NumberSamples)) {
+	    bytes += value_bytes(value);
+	    benchmark::DoNotOptimize(value);
+	}
+    }
+    state.SetItemsProcessed(state.iterations() * NumberSamples);
+    state.SetBytesProcessed(bytes);
+}
+
+template<class T>
+static void BM_Sampler(benchmark::State& state) {
+    draw_samples(state, []() { return sampler<T>(); });
+}
+BENCHMARK(BM_Sampler<bool>);
+BENCHMARK(BM_Sampler<char>);
+BENCHMARK(BM_Sampler<int8_t>);
+BENCHMARK(BM_Sampler<int16_t>);
+BENCHMARK(BM_Sampler<int32_t>);
+BENCHMARK(BM_Sampler<int64_t>);
+BENCHMARK(BM_Sampler<uint64_t>);
+BENCHMARK(BM_Sampler<float>);
+BENCHMARK(BM_Sampler<double>);
+BENCHMARK(BM_Sampler<std::chrono::nanoseconds>);
+BENCHMARK(BM_Sampler<std::string>);
+BENCHMARK(BM_Sampler<std::pair<int, double>>);
+BENCHMARK(BM_Sampler<std::tuple<int, double, int>>);
+BENCHMARK(BM_Sampler<std::array<int, 4>>);
+BENCHMARK(BM_Sampler<std::vector<int>>);
+
+// Values drawn from a range rather than the whole domain.
+template<class T>
+static void BM_SamplerRange(benchmark::State& state) {
+    draw_samples(state, []() { return sampler<T>(T{-100}, T{100}); });
+}
+BENCHMARK(BM_SamplerRange<int32_t>);
+BENCHMARK(BM_SamplerRange<int64_t>);
+BENCHMARK(BM_SamplerRange<double>);
+
+template<class T>
+static void BM_LogSampler(benchmark::State& state) {
+    draw_samples(state, []() { return log_sampler<T>(); });
+}
+BENCHMARK(BM_LogSampler<uint32_t>);
+BENCHMARK(BM_LogSampler<uint64_t>);
+
+// Strings of up to `state.range(0)` characters.
+static void BM_SamplerAlpha(benchmark::State& state) {
+    size_t length = state.range(0);
+    draw_samples(state, [=]() { return str::alpha(0, length); });
+}
+BENCHMARK(BM_SamplerAlpha)->Arg(16)->Arg(256);
+
+BENCHMARK_MAIN();
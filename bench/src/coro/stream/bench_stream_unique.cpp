@@ -0,0 +1,86 @@
+// Copyright 2024 by Mark Melton
+//
+
+#include <benchmark/benchmark.h>
+#include <set>
+#include "coro/stream/stream.h"
+
+using namespace coro;
+
+static constexpr size_t NumberKeys = 1 << 20;
+
+// Keys drawn from a range half the input size, so about a third of
+// them are duplicates.
+static const std::vector<uint64_t>& keys() {
+    static auto data = sampler<uint64_t>(0, NumberKeys / 2) | take(NumberKeys) | collect<std::vector>();
+    return data;
+}
+
+static auto identity = [](uint64_t n) { return n; };
+
+// The previous implementation backed by std::set.
+template<Stream S>
+Generator<uint64_t> unique_set(S source) {
+    std::set<uint64_t> seen;
+    for (auto n : source)
+	if (seen.insert(n).second)
+	    co_yield n;
+    co_return;
+}
+
+static void BM_UniqueSet(benchmark::State& state) {
+    for (auto _ : state) {
+	size_t count{0};
+	for (auto n : unique_set(keys())) {
+	    benchmark::DoNotOptimize(n);
+	    ++count;
+	}
+	state.counters["unique"] = count;
+    }
+    state.SetItemsProcessed(state.iterations() * NumberKeys);
+}
+BENCHMARK(BM_UniqueSet)->Unit(benchmark::kMillisecond);
+
+static void BM_UniqueFlat(benchmark::State& state) {
+    for (auto _ : state) {
+	size_t count{0};
+	for (auto n : keys() | unique(identity)) {
+	    benchmark::DoNotOptimize(n);
+	    ++count;
+	}
+	state.counters["unique"] = count;
+    }
+    state.SetItemsProcessed(state.iterations() * NumberKeys);
+}
+BENCHMARK(BM_UniqueFlat)->Unit(benchmark::kMillisecond);
+
+// Windowed dedup remembering `state.range(0)` keys.
+static void BM_UniqueLru(benchmark::State& state) {
+    for (auto _ : state) {
+	size_t count{0};
+	for (auto n : keys() | unique_lru(identity, state.range(0))) {
+	    benchmark::DoNotOptimize(n);
+	    ++count;
+	}
+	state.counters["unique"] = count;
+    }
+    state.SetItemsProcessed(state.iterations() * NumberKeys);
+}
+BENCHMARK(BM_UniqueLru)->Arg(1 << 12)->Arg(1 << 18)->Unit(benchmark::kMillisecond);
+
+// Bloom filter dedup with a false positive rate of 1 / `state.range(0)`.
+static void BM_UniqueBloom(benchmark::State& state) {
+    BloomOptions options{.expected = NumberKeys, .false_positive = 1.0 / state.range(0)};
+    for (auto _ : state) {
+	size_t count{0};
+	for (auto n : keys() | unique_bloom(identity, options)) {
+	    benchmark::DoNotOptimize(n);
+	    ++count;
+	}
+	state.counters["unique"] = count;
+    }
+    state.SetItemsProcessed(state.iterations() * NumberKeys);
+}
+BENCHMARK(BM_UniqueBloom)->Arg(100)->Arg(10000)->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
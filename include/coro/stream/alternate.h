@@ -4,6 +4,7 @@
 #pragma once
 #include <optional>
 #include "coro/stream/util.h"
+#include "coro/stream/detail/cursor.h"
 #include "core/tuple/fold.h"
 #include "core/tuple/map.h"
 #include "core/tuple/to_array.h"
@@ -40,8 +41,32 @@ Generator<const stream_value_t<S>&> alternate(std::tuple<S, Ss...> tuple) {
     co_return;
 }
 
-/// Alternate elements from a tuple of Streams until all are
-/// exhausted.
+/// Alternate elements from the runtime number of input Streams in
+/// `sources` until all are exhausted.
+///
+/// Each round yields one element from every source that is not yet
+/// exhausted in order. Exhausted sources are dropped as the round
+/// passes over them, so each element costs O(1).
+///
+/// \tparam S An input source that satisfies the **Stream** concept.
+template<Stream S>
+Generator<stream_yield_t<S>> alternate(std::vector<S> sources) {
+    auto cursors = detail::make_cursors(sources);
+    while (not cursors.empty()) {
+	size_t live{0};
+	for (auto& cursor : cursors) {
+	    co_yield *cursor.iter;
+	    ++cursor.iter;
+	    if (not cursor.done())
+		std::swap(cursors[live++], cursor);
+	}
+	cursors.resize(live);
+    }
+    co_return;
+}
+
+/// Alternate elements from a tuple or **std::vector** of Streams
+/// until all are exhausted.
 ///
 /// Returns a function that accepts a tuple of input Stream's and
 /// returns a new Stream that yields elements from the input Streams
@@ -54,7 +79,7 @@ Generator<const stream_value_t<S>&> alternate(std::tuple<S, Ss...> tuple) {
 /// ```
 /// \endrst
 inline auto alternate() {
-    return []<TupleOfStream S>(S&& source) {
+    return []<class S>(S&& source) {
 	return alternate(std::move(source));
     };
 }
@@ -2,7 +2,7 @@
 //
 
 #pragma once
-#include "coro/stream/util.h"
+#include "coro/stream/fuse.h"
 
 namespace coro {
 
@@ -14,10 +14,10 @@ namespace coro {
 template<Stream S, class F>
 size_t sapply(S source, F function) {
     size_t count{0};
-    for (auto&& value : source) {
+    detail::for_each(source, [&](auto&& value) {
 	function(value);
 	++count;
-    }
+    });
     return count;
 }
 
@@ -1,28 +1,94 @@
-// Copyright 2021, 2022 by Mark Melton
+// Copyright 2021, 2022, 2024 by Mark Melton
 //
 
 #pragma once
+#include <stdexcept>
 #include <tuple>
 #include "coro/stream/util.h"
-#include "coro/stream/sampler/integral.h"
-#include "core/tuple/fold.h"
-#include "core/tuple/map.h"
-#include "core/tuple/to_array.h"
+#include "coro/stream/detail/alias_table.h"
+#include "coro/stream/detail/bulk_random.h"
+#include "coro/stream/detail/cursor.h"
 
 namespace coro {
 
-#define APPLY_NTH(Idx)						\
-    if constexpr (std::tuple_size<decltype(tup)>() > Idx) {	\
-	if (idx == Idx) {					\
-	    auto& iter = std::get<Idx>(iterators);		\
-	    auto& end = std::get<Idx>(sentinels);		\
-	    if (iter != end) {					\
-		co_yield *iter;					\
-		++iter;						\
-	    }							\
-	}							\
+/// Choose elements uniformly from the runtime number of input Streams
+/// in `sources` until all are exhausted.
+///
+/// Each element is taken from a source chosen uniformly among those
+/// not yet exhausted. An exhausted source is swapped out of the
+/// candidates as soon as it ends, so each element costs O(1).
+///
+/// \tparam S An input source that satisfies the **Stream** concept.
+template<Stream S>
+Generator<stream_yield_t<S>> choose(std::vector<S> sources) {
+    auto cursors = detail::make_cursors(sources);
+    while (not cursors.empty()) {
+	auto& cursor = cursors[detail::lemire64(detail::rng()(), cursors.size())];
+	co_yield *cursor.iter;
+	++cursor.iter;
+	if (cursor.done()) {
+	    std::swap(cursor, cursors.back());
+	    cursors.pop_back();
+	}
     }
+    co_return;
+}
+
+/// Choose elements from the runtime number of input Streams in
+/// `sources` with probability proportional to `weights` until all
+/// sources with positive weight are exhausted.
+///
+/// The source for each element is sampled in O(1) from an alias table
+/// (Vose's method). An exhausted source is never chosen again: its
+/// weight is dropped at once and the remaining sources keep their
+/// relative weights. The table is rebuilt once the weight of the
+/// exhausted sources exceeds that of the live ones, so each source
+/// costs O(1) amortized to remove. Sources with zero weight are never
+/// read.
+///
+/// \tparam S An input source that satisfies the **Stream** concept.
+template<Stream S>
+Generator<stream_yield_t<S>> choose(std::vector<S> sources, std::vector<double> weights) {
+    if (weights.size() != sources.size())
+	throw std::runtime_error("choose: expected one weight per source");
 
+    std::vector<detail::Cursor<S>> cursors;
+    cursors.reserve(sources.size());
+    double live_weight{0};
+    size_t live{0};
+    for (size_t i = 0; i < sources.size(); ++i) {
+	cursors.push_back({std::begin(sources[i]), std::end(sources[i])});
+	if (cursors.back().done())
+	    weights[i] = 0;
+	if (weights[i] > 0) {
+	    live_weight += weights[i];
+	    ++live;
+	}
+    }
+    if (live == 0)
+	co_return;
+
+    detail::AliasTable table{weights};
+    double table_weight = live_weight;
+    while (live > 0) {
+	auto idx = table.sample(detail::rng()());
+	auto& cursor = cursors[idx];
+	if (cursor.done())
+	    continue;
+
+	co_yield *cursor.iter;
+	++cursor.iter;
+	if (cursor.done()) {
+	    live_weight -= weights[idx];
+	    weights[idx] = 0;
+	    if (--live > 0 and 2 * live_weight < table_weight) {
+		table = detail::AliasTable{weights};
+		table_weight = live_weight;
+	    }
+	}
+    }
+    co_return;
+}
 
 /// Choose elements uniformly from the given `tuple` of Streams unitl
 /// all are exhausted.
@@ -34,25 +100,20 @@ namespace coro {
 /// \tparam Ss A source(s) that satisfies the `Stream` concept.
 template<Stream S, Stream... Ss>
 Generator<streams_yield_t<S, Ss...>> choose(std::tuple<S, Ss...> tup) {
-    static_assert(sizeof...(Ss) < 5);
-    auto r = sampler<int>(0, sizeof...(Ss));
-    using namespace core::tp;
-    auto iterators = map_inplace([](auto& g) { return g.begin(); }, tup);
-    auto sentinels = map_inplace([](auto& g) { return g.end(); }, tup);
-    while (any(map([](auto& iter, auto& end) { return iter != end; }, iterators, sentinels))) {
-	auto idx = r.sample();
-	APPLY_NTH(0);
-	APPLY_NTH(1);
-	APPLY_NTH(2);
-	APPLY_NTH(3);
-	APPLY_NTH(4);
-    }
-    co_return;
+    using Y = streams_yield_t<S, Ss...>;
+    return choose(detail::as_generators<Y>(std::move(tup)));
 }
 
-#undef APPLY_NTH
+/// Choose elements from the given `tuple` of Streams with probability
+/// proportional to `weights` (see above).
+template<Stream S, Stream... Ss>
+Generator<streams_yield_t<S, Ss...>> choose(std::tuple<S, Ss...> tup, std::vector<double> weights) {
+    using Y = streams_yield_t<S, Ss...>;
+    return choose(detail::as_generators<Y>(std::move(tup)), std::move(weights));
+}
 
-/// Choose elements uniformly from a tuple of Streams unitl all are exhausted.
+/// Choose elements uniformly from a tuple or **std::vector** of
+/// Streams until all are exhausted.
 ///
 /// Returns a function that accepts a tuple of input Stream's and
 /// returns a new Stream that yields elements from the input Streams
@@ -70,4 +131,19 @@ inline auto choose() {
     };
 }
 
+/// Choose elements from a tuple or **std::vector** of Streams with
+/// probability proportional to `weights`.
+///
+/// \rst
+/// ```{code-block} c++
+/// reads * writes * deletes | choose({90, 9, 1});
+/// // 90% reads, 9% writes and 1% deletes
+/// ```
+/// \endrst
+inline auto choose(std::vector<double> weights) {
+    return [=]<class T>(T tup) {
+	return choose(std::move(tup), weights);
+    };
+}
+
 }; // coro
@@ -0,0 +1,239 @@
+// Copyright 2024 by Mark Melton
+//
+
+#pragma once
+#include <algorithm>
+#include <span>
+#include <stdexcept>
+#include <vector>
+#include "coro/stream/util.h"
+
+namespace coro {
+
+namespace detail {
+
+template<Stream S, class T>
+Generator<std::span<T>> chunked_generator(S source, size_t size) {
+    std::vector<T> buffer;
+    buffer.reserve(size);
+    for (auto&& elem : source) {
+	buffer.push_back(std::forward<decltype(elem)>(elem));
+	if (buffer.size() == size) {
+	    co_yield std::span<T>{buffer};
+	    buffer.clear();
+	}
+    }
+    if (not buffer.empty())
+	co_yield std::span<T>{buffer};
+    co_return;
+}
+
+template<Stream S, class T>
+Generator<std::span<T>> chunked_generator(S source, std::span<T> buffer) {
+    size_t idx{0};
+    for (auto&& elem : source) {
+	buffer[idx++] = std::forward<decltype(elem)>(elem);
+	if (idx == buffer.size()) {
+	    co_yield buffer;
+	    idx = 0;
+	}
+    }
+    if (idx > 0)
+	co_yield buffer.first(idx);
+    co_return;
+}
+
+template<class T>
+Generator<std::span<T>> chunk_iota_generator(size_t count, T start, T step, size_t size) {
+    std::vector<T> buffer(std::min(count, size));
+    while (count > 0) {
+	auto n = std::min(count, size);
+	for (size_t i = 0; i < n; ++i, start += step)
+	    buffer[i] = start;
+	co_yield std::span<T>{buffer.data(), n};
+	count -= n;
+    }
+    co_return;
+}
+
+}; // detail
+
+/// Return a generator that yields the elements of `source` in
+/// batches of at most `size` elements as **std::span<T>**'s.
+///
+/// Downstream stages that consume whole chunks (see
+/// `coro::chunk`) pay the coroutine resume cost once per chunk rather
+/// than once per element. The span is only valid until the generator
+/// is resumed.
+///
+/// \tparam S An input source that satisfies the **Stream** concept.
+template<Stream S, class T = stream_value_t<S>>
+Generator<std::span<T>> chunked(S source, size_t size) {
+    if (size == 0)
+	throw std::runtime_error("chunked: expected a chunk size > 0");
+    return detail::chunked_generator<S, T>(std::move(source), size);
+}
+
+/// Return a generator that yields the elements of `source` in
+/// batches written into the caller-supplied `buffer`.
+///
+/// \tparam S An input source that satisfies the **Stream** concept.
+template<Stream S, class T>
+Generator<std::span<T>> chunked(S source, std::span<T> buffer) {
+    if (buffer.empty())
+	throw std::runtime_error("chunked: expected a non-empty buffer");
+    return detail::chunked_generator<S, T>(std::move(source), buffer);
+}
+
+/// Batch the elements of a Stream into chunks of at most `size` elements.
+///
+/// \rst
+/// ```{code-block} cpp
+/// iota<int>(10) | chunked(4);
+/// // [0, 1, 2, 3], [4, 5, 6, 7], [8, 9]
+/// ```
+/// \endrst
+inline auto chunked(size_t size) {
+    return [=]<Stream S>(S&& source) {
+	return chunked<S>(std::forward<S>(source), size);
+    };
+}
+
+/// Batch the elements of a Stream into chunks written into `buffer`.
+template<class T>
+auto chunked(std::span<T> buffer) {
+    return [=]<Stream S>(S&& source) {
+	return chunked<S, T>(std::forward<S>(source), buffer);
+    };
+}
+
+/// Return a generator that yields the individual elements of a
+/// **Stream** of chunks.
+template<Stream S, class T = typename stream_value_t<S>::element_type>
+Generator<T&> unchunked(S source) {
+    for (auto&& chunk : source)
+	for (auto& elem : chunk)
+	    co_yield elem;
+    co_return;
+}
+
+/// Flatten a Stream of chunks back into a Stream of elements.
+inline auto unchunked() {
+    return []<Stream S>(S&& source) {
+	return unchunked<S>(std::forward<S>(source));
+    };
+}
+
+namespace chunk {
+
+/// Return a generator that yields `count` number of **T**'s starting
+/// with `start` and incrementing by `step` in chunks of at most
+/// `size` elements.
+template<class T>
+Generator<std::span<T>> iota(size_t count, T start = T{0}, T step = T{1}, size_t size = 1024) {
+    if (size == 0)
+	throw std::runtime_error("chunk::iota: expected a chunk size > 0");
+    return coro::detail::chunk_iota_generator(count, start, step, size);
+}
+
+/// Return a generator that yields each chunk from `source` with
+/// every element transformed by `func`.
+template<Stream S, class F,
+	 class T = typename stream_value_t<S>::element_type,
+	 class U = std::invoke_result_t<F, T&>>
+Generator<std::span<U>> transform(S source, F func) {
+    std::vector<U> buffer;
+    for (auto&& chunk : source) {
+	if constexpr (std::is_default_constructible_v<U>) {
+	    buffer.resize(chunk.size());
+	    std::transform(chunk.begin(), chunk.end(), buffer.begin(), func);
+	} else {
+	    buffer.clear();
+	    for (auto& elem : chunk)
+		buffer.push_back(func(elem));
+	}
+	co_yield std::span<U>{buffer};
+    }
+    co_return;
+}
+
+/// Transform every element of a Stream of chunks using `func`.
+///
+/// \rst
+/// ```{code-block} cpp
+/// chunk::iota<int>(1000) | chunk::transform([](int n) { return n * n; });
+/// ```
+/// \endrst
+template<class F>
+auto transform(F func) {
+    return [=]<Stream S>(S&& source) {
+	return chunk::transform<S>(std::forward<S>(source), func);
+    };
+}
+
+/// Return a generator that yields each chunk from `source`
+/// restricted to the elements for which `predicate` is true. Empty
+/// chunks are not yielded.
+template<Stream S, class P, class T = typename stream_value_t<S>::element_type>
+Generator<std::span<T>> filter(S source, P predicate) {
+    std::vector<std::remove_const_t<T>> buffer;
+    for (auto&& chunk : source) {
+	buffer.clear();
+	std::copy_if(chunk.begin(), chunk.end(), std::back_inserter(buffer), predicate);
+	if (not buffer.empty())
+	    co_yield std::span<T>{buffer};
+    }
+    co_return;
+}
+
+/// Filter the elements of a Stream of chunks using `predicate`.
+template<class P>
+auto filter(P predicate) {
+    return [=]<Stream S>(S&& source) {
+	return chunk::filter<S>(std::forward<S>(source), predicate);
+    };
+}
+
+/// Reduce the elements of a Stream of chunks into `accumulator`.
+template<Stream S, class A, class R>
+A reduce(S source, A accumulator, R&& reducer) {
+    for (auto&& chunk : source)
+	for (auto& elem : chunk)
+	    reducer(accumulator, elem);
+    return accumulator;
+}
+
+/// Reduce the elements of a Stream of chunks.
+template<class A, class R>
+auto reduce(A&& accumulator, R&& reducer) {
+    return [a = std::forward<A>(accumulator), r = std::forward<R>(reducer)]
+	<Stream S>(S&& source) mutable {
+	return chunk::reduce<S>(std::forward<S>(source),
+				std::forward<A>(a),
+				std::forward<R>(r));
+    };
+}
+
+/// Return a container **C** with all the elements from a **Stream**
+/// of chunks.
+template<class C, Stream S>
+auto collect(S source) {
+    C c;
+    for (auto&& chunk : source)
+	c.insert(c.end(), chunk.begin(), chunk.end());
+    return c;
+}
+
+/// Collect all the elements from a Stream of chunks into a container
+/// of type **C**.
+template<template<class...> class C>
+auto collect() {
+    return []<Stream S>(S&& s) {
+	using T = std::remove_const_t<typename stream_value_t<S>::element_type>;
+	return chunk::collect<C<T>, S>(std::forward<S>(s));
+    };
+}
+
+}; // chunk
+
+}; // coro
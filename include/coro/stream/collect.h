@@ -2,17 +2,53 @@
 //
 
 #pragma once
-#include "coro/stream/util.h"
+#include <algorithm>
+#include <iterator>
+#include "coro/stream/fuse.h"
 
 namespace coro {
 
+namespace detail {
+
+// The most elements `collect` reserves for a stream whose size is
+// only bounded, so that a selective filter over a long stream does
+// not allocate for elements it will never see.
+inline constexpr size_t MaxBoundedReserve = 1 << 16;
+
+}; // detail
+
 /// Return a container **C<T>** with all the elements from **Stream** `source`.
+///
+/// If `source` has a known size hint (see **stream_size_hint**) and
+/// **C** has `reserve`, the container is reserved up front. Elements
+/// yielded as rvalues are moved into the container. The elements of a
+/// **ContiguousStream** are inserted as a single range, and an owned
+/// source that already is a **C** is returned as is.
 template<class C, Stream S>
 auto collect(S source) {
-    C c;
-    for (auto&& value : source)
-	c.push_back(value);
-    return c;
+    if constexpr (std::is_same_v<S, C>) {
+	return source;
+    } else if constexpr (ContiguousStream<S> and requires (C c, stream_value_t<S> *ptr) {
+	    c.insert(c.end(), ptr, ptr);
+	}) {
+	auto first = std::data(source);
+	auto last = first + stream_size(source);
+	C c;
+	if constexpr (std::is_reference_v<S>)
+	    c.insert(c.end(), first, last);
+	else
+	    c.insert(c.end(), std::make_move_iterator(first), std::make_move_iterator(last));
+	return c;
+    } else {
+	C c;
+	if constexpr (requires { c.reserve(size_t{}); }) {
+	    auto hint = stream_size_hint(source);
+	    if (hint.known())
+		c.reserve(hint.exact ? hint.count : std::min(hint.count, detail::MaxBoundedReserve));
+	}
+	detail::for_each(source, [&](auto&& value) { c.push_back(std::forward<decltype(value)>(value)); });
+	return c;
+    }
 }
 
 /// Collect all the elements from a **Stream** and insert them into a container of type
@@ -0,0 +1,47 @@
+// Copyright (C) 2024 by Mark Melton
+//
+
+#pragma once
+#include <cstdint>
+#include <span>
+#include <vector>
+#include "coro/stream/detail/bulk_random.h"
+
+namespace coro::detail {
+
+// A table for sampling an index with probability proportional to its
+// weight in O(1) using Vose's alias method. Each slot holds a
+// threshold and an alias: a uniformly chosen slot yields itself if a
+// uniform 32-bit coin falls below its threshold and its alias
+// otherwise. Indices with zero weight are never sampled.
+class AliasTable {
+public:
+    AliasTable() = default;
+
+    // Build the table for `weights` which must be non-negative with a
+    // positive sum.
+    explicit AliasTable(std::span<const double> weights);
+
+    size_t size() const {
+	return slots_.size();
+    }
+
+    // Return an index sampled with the random word `x`: the high half
+    // selects the slot and the low half is the coin.
+    size_t sample(uint64_t x) const {
+	auto idx = lemire32(uint32_t(x >> 32), slots_.size());
+	auto& slot = slots_[idx];
+	return uint32_t(x) < slot.threshold ? idx : slot.alias;
+    }
+
+private:
+    struct Slot {
+	// The probability of keeping the slot scaled by 2^32.
+	uint64_t threshold;
+	uint32_t alias;
+    };
+
+    std::vector<Slot> slots_;
+};
+
+}; // coro::detail
@@ -0,0 +1,40 @@
+// Copyright (C) 2024 by Mark Melton
+//
+
+#pragma once
+#include <cstdint>
+#include <vector>
+
+namespace coro::detail {
+
+// A cache-blocked Bloom filter over 64-bit hashes. Each key sets
+// `probes` bits within a single 512-bit block so that a lookup touches
+// one cache line, at the cost of a slightly higher false positive rate
+// than an unblocked filter of the same size.
+class BloomFilter {
+public:
+    // Size the filter for `expected` keys at `false_positive` rate, or
+    // to `memory_bytes` if that is non-zero.
+    BloomFilter(size_t expected, double false_positive, size_t memory_bytes = 0);
+
+    // Insert `hash` returning true iff it was (probably) not present.
+    bool insert(uint64_t hash);
+
+    size_t memory_bytes() const {
+	return blocks_.size() * sizeof(Block);
+    }
+
+    size_t probes() const {
+	return probes_;
+    }
+
+private:
+    struct Block {
+	uint64_t words[8];
+    };
+
+    std::vector<Block> blocks_;
+    size_t probes_;
+};
+
+}; // coro::detail
@@ -0,0 +1,180 @@
+// Copyright (C) 2024 by Mark Melton
+//
+
+#pragma once
+#include <cstdint>
+#include <span>
+#include <type_traits>
+#include "coro/stream/detail/random.h"
+
+namespace coro::detail {
+
+// The state of a bulk engine: eight interleaved xoshiro256**
+// generators stored by state word so that word `w` of every lane is
+// contiguous: s[w][lane]. Seeded from `rng()` on first use.
+struct BulkState {
+    static constexpr size_t Lanes = 8;
+    uint64_t s[4][Lanes];
+    bool seeded{false};
+};
+
+// Fill `words` with random 64-bit words from the calling thread's bulk
+// engine: eight interleaved xoshiro256** lanes stepped with AVX-512 or
+// AVX2 when the processor supports them and portable scalar code
+// otherwise. All implementations produce the same sequence.
+void random_words(std::span<uint64_t> words);
+
+// Reseed the calling thread's bulk engine from its sampler engine.
+void reseed_random_words();
+
+// Make `state` (or the thread's own state if nullptr) the calling
+// thread's bulk engine returning the previous override.
+BulkState *exchange_bulk_state(BulkState *state);
+
+// Number of words generated per batch by the fill functions below.
+inline constexpr size_t BulkWords = 512;
+
+// Return a uniform integer in [0, range) from the 64-bit word `x` using
+// Lemire's nearly divisionless method, redrawing from the thread's
+// sampler engine in the rare case the multiply lands in the biased
+// zone. `threshold` is `-range % range`, computed only on demand.
+inline uint64_t lemire64(uint64_t x, uint64_t range) {
+    auto m = __uint128_t{x} * range;
+    auto low = uint64_t(m);
+    if (low < range) {
+	auto threshold = -range % range;
+	while (low < threshold) {
+	    m = __uint128_t{rng()()} * range;
+	    low = uint64_t(m);
+	}
+    }
+    return uint64_t(m >> 64);
+}
+
+inline uint32_t lemire32(uint32_t x, uint32_t range) {
+    auto m = uint64_t{x} * range;
+    auto low = uint32_t(m);
+    if (low < range) {
+	auto threshold = -range % range;
+	while (low < threshold) {
+	    m = uint64_t(uint32_t(rng()())) * range;
+	    low = uint32_t(m);
+	}
+    }
+    return uint32_t(m >> 32);
+}
+
+// A **UniformRandomBitGenerator** that serves the words of the calling
+// thread's bulk engine from a buffer refilled `BulkWords` at a time,
+// for distributions that consume a variable number of words per
+// sample.
+class WordBuffer : public EngineBase {
+public:
+    result_type operator()() {
+	if (next_ == BulkWords) {
+	    random_words(words_);
+	    next_ = 0;
+	}
+	return words_[next_++];
+    }
+
+private:
+    uint64_t words_[BulkWords];
+    size_t next_{BulkWords};
+};
+
+// Return the `i`'th 32-bit half of `words`.
+inline uint32_t half(const uint64_t *words, size_t i) {
+    return uint32_t(words[i / 2] >> (32 * (i % 2)));
+}
+
+// Fill `out` with integers uniformly sampled from [min, max]. Types of
+// 32 bits or less consume half a word per value and 128-bit types two
+// words per value.
+template<class T>
+requires std::is_integral_v<T>
+void fill_uniform(std::span<T> out, T min, T max) {
+    using U = std::make_unsigned_t<T>;
+    uint64_t words[BulkWords];
+
+    if constexpr (sizeof(T) > sizeof(uint64_t)) {
+	// The offset is bounded by rejecting values beyond the smallest
+	// bit mask covering `max - min`.
+	auto span = U(U(max) - U(min));
+	auto mask = span;
+	for (auto shift = 1; shift < int(sizeof(U) * CHAR_BIT); shift *= 2)
+	    mask |= mask >> shift;
+	auto draw = [](uint64_t high, uint64_t low) { return (U(high) << 64) | low; };
+
+	while (not out.empty()) {
+	    auto n = std::min(out.size(), BulkWords / 2);
+	    random_words({words, 2 * n});
+	    for (size_t i = 0; i < n; ++i) {
+		auto x = draw(words[2 * i], words[2 * i + 1]) & mask;
+		while (x > span)
+		    x = draw(rng()(), rng()()) & mask;
+		out[i] = T(U(min) + x);
+	    }
+	    out = out.subspan(n);
+	}
+    } else {
+	// Reduce the difference to `U` before widening: narrow types
+	// are otherwise promoted to (signed) int and negative.
+	auto range = uint64_t(U(U(max) - U(min))) + 1;
+	constexpr bool Narrow = sizeof(T) <= 4;
+	constexpr size_t PerWord = Narrow ? 2 : 1;
+
+	while (not out.empty()) {
+	    auto n = std::min(out.size(), BulkWords * PerWord);
+	    random_words({words, (n + PerWord - 1) / PerWord});
+	    if constexpr (Narrow) {
+		if (range == (uint64_t{1} << 32)) {
+		    for (size_t i = 0; i < n; ++i)
+			out[i] = T(U(min) + U(half(words, i)));
+		} else {
+		    for (size_t i = 0; i < n; ++i)
+			out[i] = T(U(min) + U(lemire32(half(words, i), uint32_t(range))));
+		}
+	    } else {
+		if (range == 0) {
+		    for (size_t i = 0; i < n; ++i)
+			out[i] = T(words[i]);
+		} else {
+		    for (size_t i = 0; i < n; ++i)
+			out[i] = T(U(min) + U(lemire64(words[i], range)));
+		}
+	    }
+	    out = out.subspan(n);
+	}
+    }
+}
+
+// Fill `out` with reals uniformly sampled from [min, max) using the
+// high bits of each word as the fraction (24 bits from each half word
+// for float, 53 bits for double and wider).
+template<class T>
+requires std::is_floating_point_v<T>
+void fill_uniform(std::span<T> out, T min, T max) {
+    uint64_t words[BulkWords];
+    constexpr bool Narrow = sizeof(T) <= 4;
+    constexpr size_t PerWord = Narrow ? 2 : 1;
+
+    while (not out.empty()) {
+	auto n = std::min(out.size(), BulkWords * PerWord);
+	random_words({words, (n + PerWord - 1) / PerWord});
+	if constexpr (Narrow) {
+	    for (size_t i = 0; i < n; ++i) {
+		T x = T(half(words, i) >> 8) * T(0x1.0p-24);
+		out[i] = x * max + (T(1) - x) * min;
+	    }
+	} else {
+	    for (size_t i = 0; i < n; ++i) {
+		T x = T(words[i] >> 11) * T(0x1.0p-53);
+		out[i] = x * max + (T(1) - x) * min;
+	    }
+	}
+	out = out.subspan(n);
+    }
+}
+
+}; // coro::detail
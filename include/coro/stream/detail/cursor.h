@@ -0,0 +1,35 @@
+// Copyright (C) 2024 by Mark Melton
+//
+
+#pragma once
+#include <iterator>
+#include <vector>
+
+namespace coro::detail {
+
+// The current position and end of one of a runtime number of sources
+// being consumed together.
+template<class S>
+struct Cursor {
+    decltype(std::begin(std::declval<S&>())) iter;
+    decltype(std::end(std::declval<S&>())) end;
+
+    bool done() const {
+	return iter == end;
+    }
+};
+
+// Return a cursor for each of the non-empty `sources` in order.
+template<class S>
+std::vector<Cursor<S>> make_cursors(std::vector<S>& sources) {
+    std::vector<Cursor<S>> cursors;
+    cursors.reserve(sources.size());
+    for (auto& source : sources) {
+	Cursor<S> cursor{std::begin(source), std::end(source)};
+	if (not cursor.done())
+	    cursors.push_back(std::move(cursor));
+    }
+    return cursors;
+}
+
+}; // coro::detail
@@ -0,0 +1,220 @@
+// Copyright (C) 2024 by Mark Melton
+//
+
+#pragma once
+#include <bit>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <utility>
+#include <vector>
+#include "coro/stream/engine.h"
+
+namespace coro::detail {
+
+// An open-addressing hash map with linear probing and backward-shift
+// deletion. Entries are stored inline in a power-of-two table that
+// doubles when it is three quarters full. The result of `Hash` is
+// passed through `mix64` so that weak hashers (such as the identity
+// `std::hash` for integers) still spread over the table.
+template<class K, class V, class Hash = std::hash<K>, class Equal = std::equal_to<K>>
+class FlatMap {
+public:
+    struct Entry {
+	K key;
+	[[no_unique_address]] V value;
+    };
+
+    explicit FlatMap(size_t capacity = 16, Hash hash = Hash{}, Equal equal = Equal{})
+	: hash_(std::move(hash))
+	, equal_(std::move(equal)) {
+	rehash(std::bit_ceil(std::max<size_t>(capacity, 16)));
+    }
+
+    size_t size() const {
+	return size_;
+    }
+
+    // Return a pointer to the value for `key`, or nullptr if absent.
+    V *find(const K& key) {
+	for (auto idx = home(key); slots_[idx]; idx = next(idx))
+	    if (equal_(slots_[idx]->key, key))
+		return &slots_[idx]->value;
+	return nullptr;
+    }
+
+    // Insert `key` with `value` if `key` is absent. Return a pointer
+    // to the value for `key` and whether it was inserted.
+    template<class U, class... Args>
+    std::pair<V*, bool> try_emplace(U&& key, Args&&... args) {
+	if (4 * (size_ + 1) > 3 * slots_.size())
+	    rehash(2 * slots_.size());
+	auto idx = home(key);
+	for (; slots_[idx]; idx = next(idx))
+	    if (equal_(slots_[idx]->key, key))
+		return { &slots_[idx]->value, false };
+	slots_[idx].emplace(Entry{K(std::forward<U>(key)), V(std::forward<Args>(args)...)});
+	++size_;
+	return { &slots_[idx]->value, true };
+    }
+
+    // Remove `key` returning true iff it was present.
+    bool erase(const K& key) {
+	auto idx = home(key);
+	for (; slots_[idx]; idx = next(idx))
+	    if (equal_(slots_[idx]->key, key))
+		break;
+	if (not slots_[idx])
+	    return false;
+
+	// Shift following entries of the probe run back into the hole
+	// so that lookups never need tombstones.
+	auto hole = idx;
+	for (idx = next(idx); slots_[idx]; idx = next(idx)) {
+	    auto h = home(slots_[idx]->key);
+	    if (((idx - h) & mask_) >= ((idx - hole) & mask_)) {
+		slots_[hole] = std::move(slots_[idx]);
+		hole = idx;
+	    }
+	}
+	slots_[hole].reset();
+	--size_;
+	return true;
+    }
+
+private:
+    size_t home(const K& key) const {
+	return mix64(hash_(key)) & mask_;
+    }
+
+    size_t next(size_t idx) const {
+	return (idx + 1) & mask_;
+    }
+
+    void rehash(size_t capacity) {
+	std::vector<std::optional<Entry>> old(capacity);
+	old.swap(slots_);
+	mask_ = capacity - 1;
+	for (auto& slot : old) {
+	    if (slot) {
+		auto idx = home(slot->key);
+		while (slots_[idx])
+		    idx = next(idx);
+		slots_[idx] = std::move(slot);
+	    }
+	}
+    }
+
+    Hash hash_;
+    Equal equal_;
+    std::vector<std::optional<Entry>> slots_;
+    size_t mask_{0};
+    size_t size_{0};
+};
+
+struct Empty { };
+
+// An open-addressing hash set (see **FlatMap**).
+template<class K, class Hash = std::hash<K>, class Equal = std::equal_to<K>>
+class FlatSet {
+public:
+    explicit FlatSet(size_t capacity = 16, Hash hash = Hash{}, Equal equal = Equal{})
+	: map_(capacity, std::move(hash), std::move(equal)) {
+    }
+
+    size_t size() const {
+	return map_.size();
+    }
+
+    bool contains(const K& key) {
+	return map_.find(key) != nullptr;
+    }
+
+    // Insert `key` returning true iff it was not already present.
+    template<class U>
+    bool insert(U&& key) {
+	return map_.try_emplace(std::forward<U>(key)).second;
+    }
+
+    bool erase(const K& key) {
+	return map_.erase(key);
+    }
+
+private:
+    FlatMap<K, Empty, Hash, Equal> map_;
+};
+
+// A set holding at most `capacity` keys that evicts the least recently
+// seen key to make room for a new one.
+template<class K, class Hash = std::hash<K>, class Equal = std::equal_to<K>>
+class LruSet {
+public:
+    explicit LruSet(size_t capacity, Hash hash = Hash{}, Equal equal = Equal{})
+	: capacity_(std::max<size_t>(capacity, 1))
+	, index_(2 * capacity_, std::move(hash), std::move(equal)) {
+	nodes_.reserve(capacity_);
+    }
+
+    size_t size() const {
+	return index_.size();
+    }
+
+    // Mark `key` as the most recently seen key, inserting it (and
+    // evicting the least recent key if full) if absent. Return true
+    // iff `key` was inserted.
+    template<class U>
+    bool insert(U&& key) {
+	if (auto node = index_.find(key)) {
+	    unlink(*node);
+	    push_front(*node);
+	    return false;
+	}
+
+	uint32_t node;
+	if (nodes_.size() < capacity_) {
+	    node = nodes_.size();
+	    nodes_.push_back(Node{K(std::forward<U>(key))});
+	} else {
+	    node = tail_;
+	    unlink(node);
+	    index_.erase(nodes_[node].key);
+	    nodes_[node].key = K(std::forward<U>(key));
+	}
+	index_.try_emplace(nodes_[node].key, node);
+	push_front(node);
+	return true;
+    }
+
+private:
+    static constexpr uint32_t None = ~uint32_t{0};
+
+    struct Node {
+	K key;
+	uint32_t prev{None};
+	uint32_t next{None};
+    };
+
+    void unlink(uint32_t node) {
+	auto& n = nodes_[node];
+	(n.prev == None ? head_ : nodes_[n.prev].next) = n.next;
+	(n.next == None ? tail_ : nodes_[n.next].prev) = n.prev;
+	n.prev = n.next = None;
+    }
+
+    void push_front(uint32_t node) {
+	nodes_[node].next = head_;
+	if (head_ != None)
+	    nodes_[head_].prev = node;
+	head_ = node;
+	if (tail_ == None)
+	    tail_ = node;
+    }
+
+    size_t capacity_;
+    std::vector<Node> nodes_;
+    FlatMap<K, uint32_t, Hash, Equal> index_;
+    uint32_t head_{None};
+    uint32_t tail_{None};
+};
+
+}; // coro::detail
@@ -0,0 +1,184 @@
+// Copyright (C) 2024 by Mark Melton
+//
+
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <thread>
+
+#ifndef CORO_STREAM_FRAME_POOL
+#define CORO_STREAM_FRAME_POOL 1
+#endif
+
+namespace coro::detail {
+
+// Return storage for at least `size` bytes from the calling thread's
+// pool of coroutine frames.
+void *pool_allocate(std::size_t size);
+
+// Return the storage `ptr` of `size` bytes to the calling thread's
+// pool of coroutine frames.
+void pool_deallocate(void *ptr, std::size_t size) noexcept;
+
+// Every coroutine frame is followed by a **FrameHeader** recording
+// how the frame storage must be released.
+struct FrameHeader {
+    void (*release)(void *frame, std::size_t size) noexcept;
+};
+
+// The unit of allocation for frames supplied by a user allocator.
+struct alignas(__STDCPP_DEFAULT_NEW_ALIGNMENT__) FrameUnit {
+    std::byte data[__STDCPP_DEFAULT_NEW_ALIGNMENT__];
+};
+
+constexpr std::size_t align_up(std::size_t n, std::size_t alignment) {
+    return (n + alignment - 1) & ~(alignment - 1);
+}
+
+inline FrameHeader *frame_header(void *frame, std::size_t size) {
+    auto offset = align_up(size, alignof(FrameHeader));
+    return reinterpret_cast<FrameHeader*>(static_cast<std::byte*>(frame) + offset);
+}
+
+template<class Alloc>
+constexpr std::size_t frame_allocator_offset(std::size_t size) {
+    auto offset = align_up(size, alignof(FrameHeader)) + sizeof(FrameHeader);
+    return align_up(offset, alignof(Alloc));
+}
+
+template<class Alloc>
+constexpr std::size_t frame_units(std::size_t size) {
+    auto bytes = frame_allocator_offset<Alloc>(size) + sizeof(Alloc);
+    return (bytes + sizeof(FrameUnit) - 1) / sizeof(FrameUnit);
+}
+
+inline void release_pooled_frame(void *frame, std::size_t size) noexcept {
+    pool_deallocate(frame, align_up(size, alignof(FrameHeader)) + sizeof(FrameHeader));
+}
+
+// A bump allocator over a caller-provided buffer from which the
+// frames of generators created on this thread are allocated while it
+// is active (see **ScopedFrames**). The buffer is reused once every
+// frame allocated from it has been released on the owning thread. A
+// frame destroyed on another thread (e.g. a generator handed to a
+// worker) is only counted, leaving the buffer to the owner.
+class FrameArena {
+public:
+    FrameArena(std::byte *buffer, std::size_t size) noexcept
+	: begin_(buffer)
+	, ptr_(buffer)
+	, end_(buffer + size)
+	, owner_(std::this_thread::get_id()) {
+    }
+
+    FrameArena(const FrameArena&) = delete;
+    FrameArena& operator=(const FrameArena&) = delete;
+
+    // Return `size` bytes from the buffer or nullptr if they do not fit.
+    void *allocate(std::size_t size) noexcept {
+	size = align_up(size, __STDCPP_DEFAULT_NEW_ALIGNMENT__);
+	if (size > std::size_t(end_ - ptr_)) {
+	    ++fallbacks_;
+	    return nullptr;
+	}
+	auto *frame = ptr_;
+	ptr_ += size;
+	high_water_ = std::max<std::size_t>(high_water_, ptr_ - begin_);
+	++live_;
+	return frame;
+    }
+
+    void release() noexcept {
+	if (std::this_thread::get_id() != owner_) {
+	    remote_releases_.fetch_add(1, std::memory_order_release);
+	    return;
+	}
+	if (--live_ == 0)
+	    ptr_ = begin_;
+    }
+
+    // Return the number of frames not yet released on any thread.
+    std::size_t live() const {
+	return live_ - remote_releases_.load(std::memory_order_acquire);
+    }
+    std::size_t high_water() const { return high_water_; }
+    std::size_t fallbacks() const { return fallbacks_; }
+
+private:
+    std::byte *begin_, *ptr_, *end_;
+    std::thread::id owner_;
+    std::size_t live_{0};
+    std::atomic<std::size_t> remote_releases_{0};
+    std::size_t high_water_{0};
+    std::size_t fallbacks_{0};
+};
+
+// The calling thread's active **FrameArena**, if any.
+inline FrameArena*& frame_arena() {
+    thread_local FrameArena *arena{nullptr};
+    return arena;
+}
+
+// An arena frame records its arena after the **FrameHeader**.
+inline FrameArena*& frame_arena_slot(void *frame, std::size_t size) {
+    return *reinterpret_cast<FrameArena**>(frame_header(frame, size) + 1);
+}
+
+inline void release_arena_frame(void *frame, std::size_t size) noexcept {
+    frame_arena_slot(frame, size)->release();
+}
+
+template<class Alloc>
+void release_allocator_frame(void *frame, std::size_t size) noexcept {
+    using Unit = typename std::allocator_traits<Alloc>::template rebind_alloc<FrameUnit>;
+    auto *stored = reinterpret_cast<Alloc*>(static_cast<std::byte*>(frame)
+					    + frame_allocator_offset<Alloc>(size));
+    Unit alloc{std::move(*stored)};
+    stored->~Alloc();
+    std::allocator_traits<Unit>::deallocate(alloc,
+					    static_cast<FrameUnit*>(frame),
+					    frame_units<Alloc>(size));
+}
+
+// Return storage for a coroutine frame of `size` bytes from the
+// calling thread's active frame arena if it has room and otherwise
+// from its frame pool.
+inline void *frame_allocate(std::size_t size) {
+    auto bytes = align_up(size, alignof(FrameHeader)) + sizeof(FrameHeader);
+    if (auto *arena = frame_arena()) {
+	if (auto *frame = arena->allocate(bytes + sizeof(FrameArena*))) {
+	    frame_header(frame, size)->release = &release_arena_frame;
+	    frame_arena_slot(frame, size) = arena;
+	    return frame;
+	}
+    }
+    auto *frame = pool_allocate(bytes);
+    frame_header(frame, size)->release = &release_pooled_frame;
+    return frame;
+}
+
+// Return storage for a coroutine frame of `size` bytes obtained from
+// `allocator`. A copy of `allocator` is kept alongside the frame so
+// that the frame can be released when the coroutine is destroyed.
+template<class Alloc>
+void *frame_allocate(std::size_t size, const Alloc& allocator) {
+    using Unit = typename std::allocator_traits<Alloc>::template rebind_alloc<FrameUnit>;
+    static_assert(alignof(Alloc) <= alignof(FrameUnit));
+    Unit alloc{allocator};
+    void *frame = std::allocator_traits<Unit>::allocate(alloc, frame_units<Alloc>(size));
+    ::new (static_cast<std::byte*>(frame) + frame_allocator_offset<Alloc>(size))
+	Alloc(allocator);
+    frame_header(frame, size)->release = &release_allocator_frame<Alloc>;
+    return frame;
+}
+
+// Release the storage for the coroutine frame `frame` of `size` bytes
+// using whichever mechanism allocated it.
+inline void frame_deallocate(void *frame, std::size_t size) noexcept {
+    frame_header(frame, size)->release(frame, size);
+}
+
+}; // coro::detail
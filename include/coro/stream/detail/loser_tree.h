@@ -0,0 +1,64 @@
+// Copyright (C) 2024 by Mark Melton
+//
+
+#pragma once
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace coro::detail {
+
+// A tournament tree over `k` players numbered 0..k-1. Each internal
+// node of the implicit heap-shaped tree (nodes 1..k-1 with player `i`
+// at leaf k+i) records the loser of the match played there, so after
+// the winner's key changes only the matches on the path from its leaf
+// to the root are replayed: ceil(log2 k) comparisons per element.
+//
+// The order is given by `before(a, b)` which must return true iff
+// player `a` precedes player `b`.
+class LoserTree {
+public:
+    template<class B>
+    void build(size_t k, B before) {
+	size_ = k;
+	losers_.assign(k, 0);
+	winner_ = k > 0 ? play(1, before) : 0;
+    }
+
+    // Return the current winner.
+    uint32_t winner() const {
+	return winner_;
+    }
+
+    // Replay the matches of the winner after its key has changed.
+    template<class B>
+    void replay(B before) {
+	uint32_t current = winner_;
+	for (auto node = (current + size_) / 2; node > 0; node /= 2) {
+	    if (before(losers_[node], current))
+		std::swap(losers_[node], current);
+	}
+	winner_ = current;
+    }
+
+private:
+    template<class B>
+    uint32_t play(size_t node, B& before) {
+	if (node >= size_)
+	    return node - size_;
+	auto left = play(2 * node, before);
+	auto right = play(2 * node + 1, before);
+	if (before(right, left)) {
+	    losers_[node] = left;
+	    return right;
+	}
+	losers_[node] = right;
+	return left;
+    }
+
+    size_t size_{0};
+    std::vector<uint32_t> losers_;
+    uint32_t winner_{0};
+};
+
+}; // coro::detail
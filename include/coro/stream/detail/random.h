@@ -1,12 +1,52 @@
-// Copyright (C) 2017, 2019, 2022 by Mark Melton
+// Copyright (C) 2017, 2019, 2022, 2024 by Mark Melton
 //
 
 #pragma once
 #include <random>
+#include "coro/stream/engine.h"
 
 namespace coro::detail {
 
-std::mt19937& rng();
+// The seed for engines created after the most recent `seed_rng`.
+uint64_t rng_seed();
 
+// Return a stream number not yet used by any thread.
+uint64_t next_rng_stream();
+
+// An engine owned by one thread, seeded from `rng_seed` with the next
+// unused stream.
+template<class E>
+struct ThreadEngine {
+    uint64_t stream{next_rng_stream()};
+    E engine{rng_seed(), stream};
 };
 
+template<class E>
+ThreadEngine<E>& thread_engine_state() {
+    thread_local ThreadEngine<E> state;
+    return state;
+}
+
+// Return the calling thread's engine of type `E`.
+template<class E>
+E& thread_engine() {
+    return thread_engine_state<E>().engine;
+}
+
+// The engine `rng` returns on the calling thread in place of the
+// thread's own, or nullptr.
+inline Engine*& engine_override() {
+    thread_local Engine *engine{nullptr};
+    return engine;
+}
+
+// Return the calling thread's sampler engine. Samplers call this on
+// every draw so a generator resumed on another thread uses that
+// thread's engine.
+inline Engine& rng() {
+    if (auto engine = engine_override())
+	return *engine;
+    return thread_engine<Engine>();
+}
+
+};
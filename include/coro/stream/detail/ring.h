@@ -0,0 +1,251 @@
+// Copyright (C) 2024 by Mark Melton
+//
+
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <new>
+#include <thread>
+
+namespace coro {
+
+// How a thread waits on a **Ring** that is full (producer) or empty
+// (consumer): busy-spin (yielding only occasionally so that an
+// oversubscribed machine still makes progress), yield the processor
+// between polls, or block in the kernel until woken.
+enum class WaitStrategy { Spin, Yield, Block };
+
+// Counters describing the traffic through a **Ring**. Each counter
+// has a single writer and may be read from any thread.
+struct RingStats {
+    std::atomic<uint64_t> capacity{0};
+    std::atomic<uint64_t> produced{0};
+    std::atomic<uint64_t> consumed{0};
+    // Number of times the producer waited because the ring was full.
+    std::atomic<uint64_t> full_waits{0};
+    // Number of times the consumer waited because the ring was empty.
+    std::atomic<uint64_t> empty_waits{0};
+
+    // Return the number of elements currently buffered.
+    uint64_t occupancy() const {
+	auto c = consumed.load(std::memory_order_relaxed);
+	auto p = produced.load(std::memory_order_relaxed);
+	return p > c ? p - c : 0;
+    }
+};
+
+}; // coro
+
+namespace coro::detail {
+
+// Bounded single-producer single-consumer ring buffer. Elements are
+// move-constructed into the ring by the producer and destroyed when
+// released by the consumer, so `T` need be neither copyable nor
+// default constructible.
+//
+// The consumer may lower the number of elements in flight below the
+// capacity (`set_limit`) and bound their total weight, e.g. bytes,
+// as given to `push` and `release` (`set_weight_limit`). An element
+// is always admitted to an empty ring whatever its weight.
+template<class T>
+class Ring {
+public:
+    Ring(size_t capacity, WaitStrategy wait = WaitStrategy::Yield, RingStats *stats = nullptr)
+	: capacity_(std::bit_ceil(std::max<size_t>(capacity, 1)))
+	, mask_(capacity_ - 1)
+	, wait_(wait)
+	, stats_(stats ? stats : &local_stats_)
+	, slots_(std::allocator<Slot>{}.allocate(capacity_)) {
+	stats_->capacity.store(capacity_, std::memory_order_relaxed);
+    }
+
+    Ring(const Ring&) = delete;
+    Ring& operator=(const Ring&) = delete;
+
+    ~Ring() {
+	auto tail = tail_.load(std::memory_order_acquire);
+	for (auto idx = head_.load(std::memory_order_relaxed); idx < tail; ++idx)
+	    std::destroy_at(slot(idx));
+	std::allocator<Slot>{}.deallocate(slots_, capacity_);
+    }
+
+    size_t capacity() const {
+	return capacity_;
+    }
+
+    // Consumer: admit at most `limit` (clamped to [1, capacity])
+    // elements in flight.
+    void set_limit(size_t limit) {
+	limit_.store(std::clamp<size_t>(limit, 1, capacity_), std::memory_order_relaxed);
+	signal();
+    }
+
+    // Consumer: admit elements while their total weight is at most
+    // `limit`.
+    void set_weight_limit(uint64_t limit) {
+	weight_limit_.store(limit, std::memory_order_relaxed);
+	signal();
+    }
+
+    // Producer: append `value` of `weight` waiting while the ring is
+    // full. Return false iff the consumer has cancelled.
+    template<class U>
+    bool push(U&& value, uint64_t weight = 0) {
+	auto tail = tail_.load(std::memory_order_relaxed);
+	if (not has_room(tail, weight)) {
+	    head_cache_ = head_.load(std::memory_order_acquire);
+	    if (not has_room(tail, weight)) {
+		bump(stats_->full_waits);
+		for (size_t polls = 0; true; ++polls) {
+		    auto event = events_.load(std::memory_order_acquire);
+		    head_cache_ = head_.load(std::memory_order_acquire);
+		    if (has_room(tail, weight))
+			break;
+		    if (cancelled_.load(std::memory_order_acquire))
+			return false;
+		    wait(event, polls);
+		}
+	    }
+	}
+	::new (slot(tail)) T(std::forward<U>(value));
+	if (weight > 0)
+	    produced_weight_.store(produced_weight_.load(std::memory_order_relaxed) + weight,
+				   std::memory_order_relaxed);
+	tail_.store(tail + 1, std::memory_order_release);
+	bump(stats_->produced);
+	signal();
+	return not cancelled_.load(std::memory_order_relaxed);
+    }
+
+    // Producer: no more elements will be pushed.
+    void close() {
+	closed_.store(true, std::memory_order_release);
+	signal();
+    }
+
+    // Consumer: wait until elements are available and return how
+    // many, or return zero if the ring is closed and drained.
+    size_t acquire() {
+	auto head = head_.load(std::memory_order_relaxed);
+	auto tail = tail_.load(std::memory_order_acquire);
+	if (tail != head)
+	    return tail - head;
+
+	bump(stats_->empty_waits);
+	for (size_t polls = 0; true; ++polls) {
+	    auto event = events_.load(std::memory_order_acquire);
+	    auto closed = closed_.load(std::memory_order_acquire);
+	    tail = tail_.load(std::memory_order_acquire);
+	    if (tail != head)
+		return tail - head;
+	    if (closed)
+		return 0;
+	    wait(event, polls);
+	}
+    }
+
+    // Consumer: return the element `offset` positions past the head.
+    T& operator[](size_t offset) {
+	return *slot(head_.load(std::memory_order_relaxed) + offset);
+    }
+
+    // Consumer: destroy and release the first `count` elements whose
+    // total weight is `weight`.
+    void release(size_t count, uint64_t weight = 0) {
+	auto head = head_.load(std::memory_order_relaxed);
+	for (size_t i = 0; i < count; ++i)
+	    std::destroy_at(slot(head + i));
+	if (weight > 0)
+	    consumed_weight_.store(consumed_weight_.load(std::memory_order_relaxed) + weight,
+				   std::memory_order_release);
+	head_.store(head + count, std::memory_order_release);
+	stats_->consumed.store(stats_->consumed.load(std::memory_order_relaxed) + count,
+			       std::memory_order_relaxed);
+	signal();
+    }
+
+    // Consumer: stop consuming and release a waiting producer.
+    void cancel() {
+	cancelled_.store(true, std::memory_order_release);
+	signal();
+    }
+
+private:
+    struct Slot {
+	alignas(T) std::byte data[sizeof(T)];
+    };
+
+    T *slot(uint64_t idx) {
+	return std::launder(reinterpret_cast<T*>(slots_[idx & mask_].data));
+    }
+
+    // Producer: return true if an element of `weight` may be appended
+    // at `tail` given the last observed head.
+    bool has_room(uint64_t tail, uint64_t weight) const {
+	auto count = tail - head_cache_;
+	if (count >= limit_.load(std::memory_order_relaxed))
+	    return false;
+	if (weight == 0 or count == 0)
+	    return true;
+	auto in_flight = produced_weight_.load(std::memory_order_relaxed)
+	    - consumed_weight_.load(std::memory_order_acquire);
+	return in_flight + weight <= weight_limit_.load(std::memory_order_relaxed);
+    }
+
+    static void bump(std::atomic<uint64_t>& counter) {
+	counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+
+    void wait(uint32_t event, size_t polls) {
+	switch (wait_) {
+	case WaitStrategy::Spin:
+	    if (polls % 1024 == 1023)
+		std::this_thread::yield();
+	    break;
+	case WaitStrategy::Yield:
+	    std::this_thread::yield();
+	    break;
+	case WaitStrategy::Block:
+	    events_.wait(event, std::memory_order_acquire);
+	    break;
+	}
+    }
+
+    void signal() {
+	if (wait_ == WaitStrategy::Block) {
+	    events_.fetch_add(1, std::memory_order_release);
+	    events_.notify_all();
+	}
+    }
+
+    const size_t capacity_;
+    const size_t mask_;
+    const WaitStrategy wait_;
+    RingStats local_stats_;
+    RingStats *stats_;
+    Slot *slots_;
+
+    // Padding keeps the consumer and producer indices on separate
+    // cache lines without over-aligning the ring (which may live in
+    // a coroutine frame).
+    static constexpr size_t CacheLine = 64;
+    char pad0_[CacheLine];
+    std::atomic<uint64_t> head_{0};
+    char pad1_[CacheLine];
+    std::atomic<uint64_t> tail_{0};
+    uint64_t head_cache_{0};
+    std::atomic<uint64_t> produced_weight_{0};
+    std::atomic<size_t> limit_{capacity_};
+    std::atomic<uint64_t> weight_limit_{std::numeric_limits<uint64_t>::max()};
+    char pad2_[CacheLine];
+    std::atomic<uint64_t> consumed_weight_{0};
+    std::atomic<uint32_t> events_{0};
+    std::atomic<bool> closed_{false};
+    std::atomic<bool> cancelled_{false};
+};
+
+}; // coro::detail
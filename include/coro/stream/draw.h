@@ -1,22 +1,32 @@
-// Copyright 2021, 2022 by Mark Melton
+// Copyright 2021, 2022, 2024 by Mark Melton
 //
 
 #pragma once
 #include "coro/stream/util.h"
+#include "coro/stream/detail/bulk_random.h"
 #include "coro/stream/detail/random.h"
 
 namespace coro {
 
-/// Return a generator that yields elements from the supplied
-/// `container`.
+/// Return a generator that yields elements drawn uniformly with
+/// replacement from the supplied `container` (nothing if it is empty).
+///
+/// The elements of a **ContiguousStream** are indexed directly
+/// through `std::data`.
 template<class C>
 Generator<stream_yield_t<C>> draw(C& container) {
-    auto dist = std::uniform_int_distribution<std::size_t>(0, container.size() - 1);
-    while (true) {
-	auto idx = dist.operator()(coro::detail::rng());
-	co_yield container[idx];
+    auto count = container.size();
+    if (count == 0)
+	co_return;
+    if constexpr (ContiguousStream<C&>) {
+	auto data = std::data(container);
+	while (true)
+	    co_yield data[detail::lemire64(detail::rng()(), count)];
+    } else {
+	while (true)
+	    co_yield container[detail::lemire64(detail::rng()(), count)];
     }
     co_return;
 }
 
-}; // costr
+}; // coro
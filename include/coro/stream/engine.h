@@ -0,0 +1,278 @@
+// Copyright (C) 2024 by Mark Melton
+//
+
+#pragma once
+#include <bit>
+#include <cstdint>
+#include <limits>
+
+namespace coro {
+
+// Common interface of the random engines below. Each engine satisfies
+// the standard **UniformRandomBitGenerator** requirements producing
+// 64-bit values and can be constructed from a `seed` and a `stream`
+// number. Engines with the same seed and different streams produce
+// independent sequences, so each thread (or task) can be given its own
+// stream of a common seed.
+struct EngineBase {
+    using result_type = uint64_t;
+    static constexpr uint64_t DefaultSeed = 0x853c49e6748fea9bull;
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+};
+
+// Mix the bits of `x` (the SplitMix64 finalizer).
+constexpr uint64_t mix64(uint64_t x) {
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ull;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebull;
+    return x ^ (x >> 31);
+}
+
+// SplitMix64: a 64-bit Weyl sequence passed through `mix64`. Tiny and
+// fast, with constant time jump-ahead; mostly useful for seeding the
+// other engines. Streams are derived by hashing the stream number into
+// the starting state.
+class SplitMix64 : public EngineBase {
+public:
+    static constexpr uint64_t Gamma = 0x9e3779b97f4a7c15ull;
+
+    explicit SplitMix64(uint64_t seed = DefaultSeed, uint64_t stream = 0) {
+	this->seed(seed, stream);
+    }
+
+    void seed(uint64_t seed, uint64_t stream = 0) {
+	state_ = stream == 0 ? seed : seed ^ mix64(stream * Gamma);
+    }
+
+    result_type operator()() {
+	state_ += Gamma;
+	return mix64(state_);
+    }
+
+    // Advance the engine by `n` outputs in constant time.
+    void discard(uint64_t n) {
+	state_ += n * Gamma;
+    }
+
+private:
+    uint64_t state_;
+};
+
+// xoshiro256**: 256 bits of state, excellent statistical quality and
+// the fastest engine here for scalar use. The state is filled from a
+// SplitMix64 of the seed and stream, so seeding is constant time for
+// any stream; `jump` and `long_jump` split a single seed into provably
+// non-overlapping subsequences.
+class Xoshiro256ss : public EngineBase {
+public:
+    explicit Xoshiro256ss(uint64_t seed = DefaultSeed, uint64_t stream = 0) {
+	this->seed(seed, stream);
+    }
+
+    void seed(uint64_t seed, uint64_t stream = 0) {
+	SplitMix64 init{seed, stream};
+	for (auto& s : s_)
+	    s = init();
+    }
+
+    result_type operator()() {
+	auto result = std::rotl(s_[1] * 5, 7) * 9;
+	auto t = s_[1] << 17;
+	s_[2] ^= s_[0];
+	s_[3] ^= s_[1];
+	s_[1] ^= s_[2];
+	s_[0] ^= s_[3];
+	s_[2] ^= t;
+	s_[3] = std::rotl(s_[3], 45);
+	return result;
+    }
+
+    void discard(uint64_t n) {
+	for (; n > 0; --n)
+	    (*this)();
+    }
+
+    // Advance the engine by 2^128 outputs.
+    void jump() {
+	static constexpr uint64_t Jump[] = {
+	    0x180ec6d33cfd0abaull, 0xd5a61266f0c9392cull,
+	    0xa9582618e03fc9aaull, 0x39abdc4529b1661cull };
+	apply(Jump);
+    }
+
+    // Advance the engine by 2^192 outputs.
+    void long_jump() {
+	static constexpr uint64_t LongJump[] = {
+	    0x76e15d3efefdcbbfull, 0xc5004e441c522fb3ull,
+	    0x77710069854ee241ull, 0x39109bb02acbe635ull };
+	apply(LongJump);
+    }
+
+private:
+    void apply(const uint64_t (&poly)[4]) {
+	uint64_t t[4] = { 0, 0, 0, 0 };
+	for (auto word : poly) {
+	    for (int b = 0; b < 64; ++b) {
+		if (word & (uint64_t{1} << b))
+		    for (int i = 0; i < 4; ++i)
+			t[i] ^= s_[i];
+		(*this)();
+	    }
+	}
+	for (int i = 0; i < 4; ++i)
+	    s_[i] = t[i];
+    }
+
+    uint64_t s_[4];
+};
+
+// PCG64 (XSL-RR 128/64): a 128-bit linear congruential generator with
+// a permuted output. The stream number selects the LCG increment so
+// every stream is a distinct sequence, and `discard` runs in
+// logarithmic time.
+class Pcg64 : public EngineBase {
+public:
+    explicit Pcg64(uint64_t seed = DefaultSeed, uint64_t stream = 0) {
+	this->seed(seed, stream);
+    }
+
+    void seed(uint64_t seed, uint64_t stream = 0) {
+	inc_ = (__uint128_t{stream} << 1) | 1;
+	state_ = 0;
+	step();
+	state_ += seed;
+	step();
+    }
+
+    result_type operator()() {
+	step();
+	auto value = uint64_t(state_ >> 64) ^ uint64_t(state_);
+	return std::rotr(value, int(state_ >> 122));
+    }
+
+    void discard(uint64_t n) {
+	__uint128_t mult{Multiplier}, plus{inc_};
+	__uint128_t acc_mult{1}, acc_plus{0};
+	for (; n > 0; n >>= 1) {
+	    if (n & 1) {
+		acc_mult *= mult;
+		acc_plus = acc_plus * mult + plus;
+	    }
+	    plus = (mult + 1) * plus;
+	    mult *= mult;
+	}
+	state_ = acc_mult * state_ + acc_plus;
+    }
+
+private:
+    static constexpr __uint128_t Multiplier =
+	(__uint128_t{2549297995355413924ull} << 64) | 4865540595714422341ull;
+
+    void step() {
+	state_ = state_ * Multiplier + inc_;
+    }
+
+    __uint128_t state_;
+    __uint128_t inc_;
+};
+
+// Philox4x64-10: a counter-based engine that encrypts a 256-bit
+// counter with the key derived from the seed. The stream number forms
+// the high half of the counter, so streams never overlap, and
+// `discard` is constant time. Each round produces four outputs.
+class Philox4x64 : public EngineBase {
+public:
+    explicit Philox4x64(uint64_t seed = DefaultSeed, uint64_t stream = 0) {
+	this->seed(seed, stream);
+    }
+
+    void seed(uint64_t seed, uint64_t stream = 0) {
+	key_[0] = seed;
+	key_[1] = mix64(seed);
+	counter_[0] = counter_[1] = 0;
+	counter_[2] = stream;
+	counter_[3] = 0;
+	index_ = 4;
+    }
+
+    result_type operator()() {
+	if (index_ == 4) {
+	    generate();
+	    increment(1);
+	    index_ = 0;
+	}
+	return output_[index_++];
+    }
+
+    void discard(uint64_t n) {
+	// Consume what remains of the current block, skip whole blocks
+	// by counter arithmetic and then generate the partial block.
+	auto buffered = 4 - index_;
+	if (n <= buffered) {
+	    index_ += n;
+	    return;
+	}
+	n -= buffered;
+	increment(n / 4);
+	index_ = 4;
+	if (auto rem = n % 4) {
+	    generate();
+	    increment(1);
+	    index_ = rem;
+	}
+    }
+
+private:
+    void increment(uint64_t n) {
+	auto old = counter_[0];
+	counter_[0] += n;
+	if (counter_[0] < old)
+	    ++counter_[1];
+    }
+
+    static void mulhilo(uint64_t a, uint64_t b, uint64_t& hi, uint64_t& lo) {
+	auto product = __uint128_t{a} * b;
+	hi = uint64_t(product >> 64);
+	lo = uint64_t(product);
+    }
+
+    void generate() {
+	uint64_t c[4] = { counter_[0], counter_[1], counter_[2], counter_[3] };
+	uint64_t k[2] = { key_[0], key_[1] };
+	for (int round = 0; round < 10; ++round) {
+	    if (round > 0) {
+		k[0] += 0x9e3779b97f4a7c15ull;
+		k[1] += 0xbb67ae8584caa73bull;
+	    }
+	    uint64_t hi0, lo0, hi1, lo1;
+	    mulhilo(0xd2e7470ee14c6c93ull, c[0], hi0, lo0);
+	    mulhilo(0xca5a826395121157ull, c[2], hi1, lo1);
+	    c[0] = hi1 ^ c[1] ^ k[0];
+	    c[1] = lo1;
+	    c[2] = hi0 ^ c[3] ^ k[1];
+	    c[3] = lo0;
+	}
+	for (int i = 0; i < 4; ++i)
+	    output_[i] = c[i];
+    }
+
+    uint64_t key_[2];
+    uint64_t counter_[4];
+    uint64_t output_[4];
+    uint64_t index_;
+};
+
+// The engine used by the samplers, selected at build time.
+#ifndef CORO_STREAM_ENGINE
+#define CORO_STREAM_ENGINE Xoshiro256ss
+#endif
+
+using Engine = CORO_STREAM_ENGINE;
+
+/// Set the seed used by the calling thread's engine and by the engines
+/// of threads that first draw a random value after this call. Each
+/// thread uses its own stream of the seed.
+void seed_rng(uint64_t seed);
+
+}; // coro
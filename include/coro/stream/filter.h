@@ -6,6 +6,25 @@
 
 namespace coro {
 
+namespace detail {
+
+template<Stream S, class P>
+Generator<stream_yield_t<S>> filter_generator(S source, P predicate) {
+    if constexpr (ContiguousStream<S>) {
+	auto data = std::data(source);
+	for (size_t i = 0, n = stream_size(source); i < n; ++i)
+	    if (predicate(data[i]))
+		co_yield data[i];
+    } else {
+	for (auto&& element : source)
+	    if (predicate(element))
+		co_yield element;
+    }
+    co_return;
+}
+
+}; // detail
+
 /// Filter values from `source` using the given `predicate`.
 ///
 /// Returns a **Generator** that yields only those values from `source`
@@ -14,11 +33,11 @@ namespace coro {
 /// \tparam S An input source that satisfies the **Stream** concept.
 /// \tparam P A predicate that evaluates to bool for a Stream element.
 template<Stream S, class P>
-Generator<stream_yield_t<S>> filter(S source, P&& predicate) {
-    for (auto&& element : source)
-	if (predicate(element))
-	    co_yield element;
-    co_return;
+Generator<stream_yield_t<S>> filter(S source, P predicate) {
+    auto hint = stream_size_hint(source).bound();
+    auto g = detail::filter_generator<S, P>(std::forward<S>(source), std::move(predicate));
+    g.size_hint(hint);
+    return g;
 }
 
 /// Filter values using the given `predicate`.
@@ -7,11 +7,28 @@
 namespace coro {
 
 /// Return a container **C<T>** with all the elements from **Stream** `source`.
+///
+/// The elements of containers yielded as rvalues are moved, and the
+/// first such container is adopted whole if it is a **C**.
 template<class C, Stream S>
 auto flatten(S source) {
     C c;
-    for (auto&& value : source)
-	c.insert(c.end(), value.begin(), value.end());
+    for (auto&& value : source) {
+	using V = decltype(value);
+	if constexpr (std::is_rvalue_reference_v<V>) {
+	    if constexpr (std::is_same_v<std::remove_cvref_t<V>, C>) {
+		if (c.empty()) {
+		    c = std::move(value);
+		    continue;
+		}
+	    }
+	    c.insert(c.end(),
+		     std::make_move_iterator(value.begin()),
+		     std::make_move_iterator(value.end()));
+	} else {
+	    c.insert(c.end(), value.begin(), value.end());
+	}
+    }
     return c;
 }
 
@@ -0,0 +1,294 @@
+// Copyright 2024 by Mark Melton
+//
+
+#pragma once
+#include <optional>
+#include <tuple>
+#include "coro/stream/util.h"
+
+namespace coro {
+
+namespace detail {
+
+// A fused stage wraps a downstream sink `k`, a function that accepts
+// one element and returns false once no more elements are wanted, in
+// an upstream sink. `result_t<In>` is the type the stage passes
+// downstream when it receives an `In` and `hint` maps the size hint
+// of its input to that of its output.
+
+template<class P>
+struct FilterStage {
+    P predicate;
+
+    template<class In>
+    using result_t = In;
+
+    bool live() const { return true; }
+
+    SizeHint hint(SizeHint in) const { return in.bound(); }
+
+    template<class K>
+    auto wrap(K k) {
+	return [this, k](auto&& elem) mutable {
+	    if (predicate(elem))
+		return k(std::forward<decltype(elem)>(elem));
+	    return true;
+	};
+    }
+};
+
+template<class F>
+struct TransformStage {
+    F func;
+
+    template<class In>
+    using result_t = std::invoke_result_t<F&, In>;
+
+    bool live() const { return true; }
+
+    SizeHint hint(SizeHint in) const { return in; }
+
+    template<class K>
+    auto wrap(K k) {
+	return [this, k](auto&& elem) mutable {
+	    return k(func(std::forward<decltype(elem)>(elem)));
+	};
+    }
+};
+
+struct TakeStage {
+    size_t count;
+
+    template<class In>
+    using result_t = In;
+
+    bool live() const { return count > 0; }
+
+    SizeHint hint(SizeHint in) const { return in.limit(count); }
+
+    template<class K>
+    auto wrap(K k) {
+	return [k, remaining = count](auto&& elem) mutable {
+	    --remaining;
+	    return k(std::forward<decltype(elem)>(elem)) and remaining > 0;
+	};
+    }
+};
+
+template<class In, class... Stages>
+struct fused_result;
+
+template<class In>
+struct fused_result<In> {
+    using type = In;
+};
+
+template<class In, class Stage, class... Stages>
+struct fused_result<In, Stage, Stages...> {
+    using type = typename fused_result<typename Stage::template result_t<In>, Stages...>::type;
+};
+
+}; // detail
+
+/// A lazily evaluated chain of `fuse::filter`, `fuse::transform` and
+/// `fuse::take` stages over `source`.
+///
+/// The stages are composed at compile time into a single loop that
+/// runs when the chain reaches a terminal operation (`apply`, `reduce`
+/// or `collect`), so the whole chain costs no coroutine frames or
+/// resumes beyond those of `source`. Used as an ordinary **Stream**
+/// (e.g. iterated or passed to another operator), the chain is
+/// materialized as a single **Generator**.
+///
+/// \tparam S An input source that satisfies the **Stream** concept.
+/// \tparam Stages The fused stages in order.
+template<class S, class... Stages>
+class Fused {
+public:
+    using element_type = typename detail::fused_result<stream_yield_t<S>, Stages...>::type;
+    using value_type = std::remove_cvref_t<element_type>;
+    using yield_type = std::conditional_t<std::is_lvalue_reference_v<element_type>,
+					  element_type,
+					  std::remove_reference_t<element_type>&&>;
+
+    Fused(S source, std::tuple<Stages...> stages)
+	: source_(std::forward<S>(source))
+	, stages_(std::move(stages)) {
+    }
+
+    // Return a chain with `stage` appended.
+    template<class Stage>
+    Fused<S, Stages..., Stage> append(Stage stage) && {
+	return { std::forward<S>(source_), std::tuple_cat(std::move(stages_), std::tuple{stage}) };
+    }
+
+    // Return the size hint of `source` passed through the stages.
+    SizeHint size_hint() const {
+	return std::apply([&](const auto&... stage) {
+	    auto hint = stream_size_hint(source_);
+	    ((hint = stage.hint(hint)), ...);
+	    return hint;
+	}, stages_);
+    }
+
+    // Pass each element through the stages to `sink` until the source
+    // is exhausted or a stage or `sink` returns false.
+    template<class K>
+    void run(K sink) {
+	if (not std::apply([](auto&... stage) { return (stage.live() and ...); }, stages_))
+	    return;
+	auto chain = compose<sizeof...(Stages)>(std::move(sink));
+	for (auto&& elem : source_)
+	    if (not chain(std::forward<decltype(elem)>(elem)))
+		break;
+    }
+
+    // Materialize the chain as a generator.
+    Generator<yield_type> generator() && {
+	auto hint = size_hint();
+	auto g = materialize(std::forward<S>(source_), std::move(stages_));
+	g.size_hint(hint);
+	return g;
+    }
+
+    auto begin() {
+	generator_.emplace(std::move(*this).generator());
+	return generator_->begin();
+    }
+
+    auto end() {
+	return typename Generator<yield_type>::sentinel{};
+    }
+
+private:
+    template<size_t I, class K>
+    auto compose(K sink) {
+	if constexpr (I == 0)
+	    return sink;
+	else
+	    return compose<I - 1>(std::get<I - 1>(stages_).wrap(std::move(sink)));
+    }
+
+    static Generator<yield_type> materialize(S source, std::tuple<Stages...> stages) {
+	// Each element that survives the stages is parked in `out`
+	// (by address for lvalues) and yielded from the loop body.
+	using Slot = std::conditional_t<std::is_lvalue_reference_v<element_type>,
+					std::remove_reference_t<element_type>*,
+					std::optional<value_type>>;
+	Fused fused{std::forward<S>(source), std::move(stages)};
+	Slot out{};
+	bool more{true};
+	auto chain = fused.template compose<sizeof...(Stages)>([&](auto&& elem) {
+	    if constexpr (std::is_lvalue_reference_v<element_type>)
+		out = std::addressof(elem);
+	    else
+		out.emplace(std::forward<decltype(elem)>(elem));
+	    return true;
+	});
+
+	if (not std::apply([](auto&... stage) { return (stage.live() and ...); }, fused.stages_))
+	    co_return;
+	for (auto&& elem : fused.source_) {
+	    more = chain(std::forward<decltype(elem)>(elem));
+	    if (out) {
+		if constexpr (std::is_lvalue_reference_v<element_type>)
+		    co_yield *out;
+		else
+		    co_yield std::move(*out);
+		out = Slot{};
+	    }
+	    if (not more)
+		break;
+	}
+	co_return;
+    }
+
+    S source_;
+    std::tuple<Stages...> stages_;
+    std::optional<Generator<yield_type>> generator_;
+};
+
+template<class S, class... Stages>
+struct stream_traits<Fused<S, Stages...>> : public std::true_type {
+    using value_type = typename Fused<S, Stages...>::value_type;
+    using yield_type = typename Fused<S, Stages...>::yield_type;
+    static SizeHint size_hint(const Fused<S, Stages...>& f) { return f.size_hint(); }
+};
+
+namespace detail {
+
+template<class T>
+struct is_fused : std::false_type { };
+
+template<class S, class... Stages>
+struct is_fused<Fused<S, Stages...>> : std::true_type { };
+
+template<class T>
+constexpr bool is_fused_v = is_fused<std::remove_cvref_t<T>>::value;
+
+// Return `source` with `stage` appended if it is already a fused
+// chain (and not an lvalue we must leave intact), or a new chain
+// starting with `stage` otherwise.
+template<Stream S, class Stage>
+auto fuse_stage(S&& source, Stage stage) {
+    if constexpr (is_fused_v<S> and not std::is_lvalue_reference_v<S>)
+	return std::move(source).append(std::move(stage));
+    else
+	return Fused<S, Stage>{std::forward<S>(source), std::tuple{std::move(stage)}};
+}
+
+// Call `func` with each element of `source`, running a fused chain as
+// a single loop.
+template<class S, class F>
+void for_each(S& source, F func) {
+    if constexpr (is_fused_v<S>) {
+	source.run([&](auto&& elem) {
+	    func(std::forward<decltype(elem)>(elem));
+	    return true;
+	});
+    } else {
+	for (auto&& elem : source)
+	    func(std::forward<decltype(elem)>(elem));
+    }
+}
+
+}; // detail
+
+namespace fuse {
+
+/// Fuse a filter by `predicate` into the preceding chain.
+///
+/// \rst
+/// ```{code-block} cpp
+/// iota<int>(1000)
+///     | fuse::transform([](int n) { return n * n; })
+///     | fuse::filter([](int n) { return n % 3 == 0; })
+///     | fuse::take(10)
+///     | reduce(0, [](int& acc, int n) { acc += n; });
+/// ```
+/// \endrst
+template<class P>
+auto filter(P predicate) {
+    return [=]<Stream S>(S&& source) {
+	return detail::fuse_stage(std::forward<S>(source), detail::FilterStage<P>{predicate});
+    };
+}
+
+/// Fuse a transformation by `func` into the preceding chain.
+template<class F>
+auto transform(F func) {
+    return [=]<Stream S>(S&& source) {
+	return detail::fuse_stage(std::forward<S>(source), detail::TransformStage<F>{func});
+    };
+}
+
+/// Fuse taking the first `count` elements into the preceding chain.
+inline auto take(size_t count) {
+    return [=]<Stream S>(S&& source) {
+	return detail::fuse_stage(std::forward<S>(source), detail::TakeStage{count});
+    };
+}
+
+}; // fuse
+
+}; // coro
@@ -5,10 +5,49 @@
 
 #include <coroutine>
 #include <exception>
+#include <limits>
 #include <stdexcept>
+#include <utility>
+#include "coro/stream/detail/frame_pool.h"
 
 namespace coro {
 
+// The number of elements a stream will yield, either exactly or at
+// most `count`, or unknown.
+struct SizeHint {
+    static constexpr size_t Unknown = std::numeric_limits<size_t>::max();
+
+    size_t count{Unknown};
+    bool exact{false};
+
+    bool known() const {
+	return count != Unknown;
+    }
+
+    // Return the hint for at most `n` of these elements.
+    SizeHint limit(size_t n) const {
+	return count <= n ? *this : SizeHint{n, exact};
+    }
+
+    // Return the hint for a subset of these elements.
+    SizeHint bound() const {
+	return { count, false };
+    }
+};
+
+namespace detail {
+
+// The exception thrown by a nested generator on this thread while it
+// is handed to its parent. The parent resumes immediately after the
+// nested generator finishes, so one slot per thread suffices and the
+// nesting levels need not each own an **std::exception_ptr**.
+inline std::exception_ptr& pending_exception() {
+    thread_local std::exception_ptr exception;
+    return exception;
+}
+
+}; // detail
+
 // (possibly recusrive) Generator using symmetric transfer.
 //
 template<class Reference, class Value = std::remove_cvref_t<Reference>>
@@ -27,15 +66,49 @@ public:
     class promise_type {
     public:
 	promise_type() : root_or_leaf_(this) { }
+
+	// Coroutine frames are allocated from a thread-local pool of
+	// size classes.
+	static void *operator new(std::size_t size) {
+	    return detail::frame_allocate(size);
+	}
+
+	// A generator whose leading parameters are `std::allocator_arg,
+	// allocator` has its frame allocated from `allocator`.
+	template<class Alloc, class... Args>
+	static void *operator new(std::size_t size,
+				  std::allocator_arg_t,
+				  const Alloc& allocator,
+				  const Args&...) {
+	    return detail::frame_allocate(size, allocator);
+	}
+
+	// Member function generators receive the object as the first
+	// argument.
+	template<class This, class Alloc, class... Args>
+	static void *operator new(std::size_t size,
+				  const This&,
+				  std::allocator_arg_t,
+				  const Alloc& allocator,
+				  const Args&...) {
+	    return detail::frame_allocate(size, allocator);
+	}
+
+	static void operator delete(void *ptr, std::size_t size) noexcept {
+	    detail::frame_deallocate(ptr, size);
+	}
 	
 	Generator get_return_object() noexcept {
 	    return Generator(handle_type::from_promise(*this));
 	}
 	
+	// An exception escaping a nested generator is rethrown in its
+	// parent (see yield_sequence_awaiter).
 	void unhandled_exception() {
-	    if (exception_ == nullptr)
+	    if (failed_ == nullptr)
 		throw;
-	    *exception_ = std::current_exception();
+	    *failed_ = true;
+	    detail::pending_exception() = std::current_exception();
 	}
 
 	// co_return is a noop.
@@ -90,7 +163,7 @@ public:
 	// yielded from within a Generator. 
 	struct yield_sequence_awaiter {
 	    Generator generator_;
-	    std::exception_ptr exception_;
+	    bool failed_{false};
 
 	    // Taking ownership of the nested generator ensures frames
 	    // are destroyed in reverse order of creation.
@@ -124,15 +197,15 @@ public:
 
 		// Parent tracks the immediate parent promise.
 		nested.parent_ = &current;
-		nested.exception_ = &exception_;
+		nested.failed_ = &failed_;
 
 		return generator_.coro_;
 	    }
 
-	    // If there was an exception, throw it.
+	    // If the nested generator threw, rethrow its exception.
 	    void await_resume() {
-		if (exception_)
-		    std::rethrow_exception(std::move(exception_));
+		if (failed_) [[unlikely]]
+		    std::rethrow_exception(std::exchange(detail::pending_exception(), nullptr));
 	    }
 	};
 
@@ -161,7 +234,7 @@ public:
 	promise_type *root_or_leaf_;
 	// Pointer to the promise for the parent generator, if any.
 	promise_type *parent_ = nullptr;
-	std::exception_ptr *exception_ = nullptr;
+	bool *failed_ = nullptr;
 	std::add_pointer_t<Reference> value_;
     };
 
@@ -239,10 +312,12 @@ public:
     
     Generator(Generator&& other) noexcept {
 	std::swap(coro_, other.coro_);
+	std::swap(hint_, other.hint_);
     }
 
     Generator& operator=(Generator& other) noexcept {
 	std::swap(coro_, other.coro_);
+	std::swap(hint_, other.hint_);
 	return *this;
     }
     
@@ -280,6 +355,16 @@ public:
 	return {};
     }
 
+    // Return the number of elements the generator was created to
+    // yield, if it is known.
+    SizeHint size_hint() const {
+	return hint_;
+    }
+
+    void size_hint(SizeHint hint) {
+	hint_ = hint;
+    }
+
     // Return the next value from the generator unconditionally. Throw
     // an exception if the generator is exhausted.
     Reference sample() {
@@ -296,6 +381,7 @@ private:
     { }
 
     handle_type coro_{nullptr};
+    SizeHint hint_;
 };
 
 }; // coro
@@ -2,7 +2,9 @@
 //
 
 #pragma once
+#include <span>
 #include "coro/stream/util.h"
+#include "coro/stream/chunk.h"
 #include "coro/stream/repeat.h"
 #include "core/tuple/from_vector.h"
 
@@ -11,13 +13,38 @@ namespace coro {
 /// Return a generator that yields **std::vector<T>**'s. For each count yielded fromm the
 /// supplied **Generator<size_t>**`gsize`, the generator yields a vector of `T` with count
 /// elements yielded from the supplied **Generator<`T`>** `generator`.
+///
+/// The groups of a **ContiguousStream** are each copied (or moved from
+/// an owned source) as a single range.
 template<Stream S, Stream R>
 Generator<std::vector<stream_value_t<S>>&&> group(S source, R sizer) {
     std::vector<stream_value_t<S>> data;
+    if constexpr (ContiguousStream<S>) {
+	auto ptr = std::data(source);
+	auto remaining = stream_size(source);
+	for (size_t count : sizer) {
+	    // As below, a short final group is kept only if it has at
+	    // least as many elements as it is short of.
+	    auto available = std::min<size_t>(count, remaining);
+	    if (available < count - available)
+		break;
+	    if constexpr (std::is_reference_v<S>)
+		data.assign(ptr, ptr + available);
+	    else
+		data.assign(std::make_move_iterator(ptr), std::make_move_iterator(ptr + available));
+	    ptr += available;
+	    remaining -= available;
+	    co_yield data;
+	    data.clear();
+	}
+	co_return;
+    }
+
     auto iter = std::begin(source);
     auto end = std::end(source);
     
     for (auto count : sizer) {
+	data.reserve(count);
 	while (count > 0 and iter != end) {
 	    data.push_back(*iter);
 	    ++iter;
@@ -57,4 +84,66 @@ inline auto group(size_t count) {
     };
 }
 
+/// Group elements from a Stream into spans of length `count` (the last
+/// span may be shorter).
+///
+/// Unlike `group(count)`, the elements are written into a single buffer
+/// reserved up front and reused for every group, so no allocation
+/// happens after the first group. Each span is only valid until the
+/// generator is resumed; copy it if the group must be kept.
+///
+/// \rst
+/// ```{code-block} cpp
+/// records | group_span(1000) | apply([&](std::span<Record> batch) { db.insert(batch); });
+/// ```
+/// \endrst
+inline auto group_span(size_t count) {
+    return chunked(count);
+}
+
+/// Return a generator that yields the elements of `source` in spans
+/// whose cumulative `size_fn` is at most `limit`.
+///
+/// An element whose size alone exceeds `limit` is yielded as a group
+/// of one. The buffer is reused for every group, so each span is only
+/// valid until the generator is resumed.
+///
+/// \tparam S An input source that satisfies the **Stream** concept.
+/// \tparam F A function mapping **const T&** to a **size_t**.
+template<Stream S, class F, class T = stream_value_t<S>>
+Generator<std::span<T>> group_by_bytes(S source, size_t limit, F size_fn) {
+    std::vector<T> buffer;
+    size_t bytes{0};
+    for (auto&& elem : source) {
+	size_t n = size_fn(std::as_const(elem));
+	if (not buffer.empty() and bytes + n > limit) {
+	    co_yield std::span<T>{buffer};
+	    buffer.clear();
+	    bytes = 0;
+	}
+	buffer.push_back(std::forward<decltype(elem)>(elem));
+	bytes += n;
+    }
+    if (not buffer.empty())
+	co_yield std::span<T>{buffer};
+    co_return;
+}
+
+/// Group elements from a Stream into spans whose cumulative payload,
+/// as measured by `size_fn`, is at most `limit`.
+///
+/// \rst
+/// ```{code-block} cpp
+/// read_lines_plain(file)
+///     | group_by_bytes(1 << 20, [](const std::string& s) { return s.size(); })
+///     | apply(upload);
+/// ```
+/// \endrst
+template<class F>
+auto group_by_bytes(size_t limit, F size_fn) {
+    return [=]<Stream S>(S&& source) {
+	return group_by_bytes<S>(std::forward<S>(source), limit, size_fn);
+    };
+}
+
 }; // coro
@@ -1,8 +1,9 @@
-// Copyright 2021, 2022 by Mark Melton
+// Copyright 2021, 2022, 2024 by Mark Melton
 //
 
 #pragma once
 #include <string>
+#include <string_view>
 #include "coro/stream/util.h"
 
 namespace coro {
@@ -18,4 +19,12 @@ Generator<std::string&&> read_lines(Readable auto& readable) {
 /// Return a generator that reads lines from the plain **File** `file`.
 Generator<std::string&&> read_lines_plain(std::string_view file);
 
+/// Return a generator that reads lines from the plain **File** `file`
+/// by memory mapping it.
+///
+/// The yielded views point directly into the mapping and remain valid
+/// until the generator is destroyed. Throws **std::runtime_error** if
+/// the file cannot be opened or mapped.
+Generator<std::string_view> read_lines_mmap(std::string_view file);
+
 }; // coro
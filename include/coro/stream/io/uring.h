@@ -0,0 +1,97 @@
+// Copyright 2024 by Mark Melton
+//
+
+#pragma once
+#include <memory>
+#include <string_view>
+#include "coro/stream/util.h"
+#include "coro/stream/io/write_lines.h"
+
+namespace coro {
+
+/// Options for the asynchronous `read_lines_uring` and `write_lines_uring`.
+struct AsyncOptions {
+    /// The size of each I/O buffer.
+    size_t block_bytes{1 << 20};
+    /// The number of buffers, i.e. the number of requests kept in flight.
+    size_t depth{3};
+    /// Use io_uring if the kernel supports it; otherwise (or if false)
+    /// a background thread issues `pread`/`pwrite` calls.
+    bool uring{true};
+};
+
+namespace detail {
+
+// Read a file as a sequence of blocks keeping up to `depth` reads in
+// flight ahead of the consumer.
+class BlockReader {
+public:
+    // Throws **std::runtime_error** if `file` cannot be opened.
+    BlockReader(std::string_view file, const AsyncOptions& options);
+    ~BlockReader();
+
+    // Return the next block of the file, or an empty view at the end
+    // of the file. The view is valid until the next call.
+    std::string_view next();
+
+    // Return true iff the reads are issued through io_uring.
+    bool uring() const;
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> impl_;
+};
+
+// Write a file as a sequence of blocks keeping up to `depth` writes
+// in flight behind the producer.
+class BlockWriter {
+public:
+    // Throws **std::runtime_error** if `file` cannot be opened.
+    BlockWriter(std::string_view file, const AsyncOptions& options);
+
+    // Waits for any writes in flight. Unsubmitted data is discarded
+    // unless `finish` has been called.
+    ~BlockWriter();
+
+    void write_line(std::string_view line);
+
+    // Submit any buffered data, wait for all writes and return the
+    // statistics. Throws **std::runtime_error** if a write fails.
+    WriteStats finish();
+
+    // Return true iff the writes are issued through io_uring.
+    bool uring() const;
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> impl_;
+};
+
+}; // detail
+
+/// Return a generator that reads lines from the plain **File** `file`
+/// with several block reads kept in flight through io_uring (or a
+/// background `pread` thread where io_uring is unavailable).
+///
+/// The yielded views are valid until the generator is resumed. Throws
+/// **std::runtime_error** if the file cannot be opened or read.
+Generator<std::string_view> read_lines_uring(std::string_view file, AsyncOptions options = {});
+
+/// Write lines from the supplied **Stream** `source` to `file` with
+/// several block writes kept in flight through io_uring (or a
+/// background `pwrite` thread where io_uring is unavailable).
+WriteStats write_lines_uring(Stream auto source, std::string_view file, AsyncOptions options = {}) {
+    detail::BlockWriter writer{file, options};
+    for (const auto& line : source)
+	writer.write_line(std::string_view{line.data(), line.size()});
+    return writer.finish();
+}
+
+/// Write lines to `file` asynchronously.
+inline auto write_lines_uring(std::string_view file, AsyncOptions options = {}) {
+    return [=]<Stream S>(S&& source) {
+	return write_lines_uring(std::forward<S>(source), file, options);
+    };
+}
+
+}; // coro
@@ -1,8 +1,11 @@
-// Copyright 2021, 2022, 2023 by Mark Melton
+// Copyright 2021, 2022, 2023, 2024 by Mark Melton
 //
 
 #pragma once
+#include <chrono>
 #include <fstream>
+#include <string_view>
+#include <vector>
 #include "coro/stream/util.h"
 
 namespace coro {
@@ -39,4 +42,108 @@ inline auto write_lines(std::string_view file) {
     };
 }
 
+/// Options for the buffered `write_lines_fd` and `write_lines_file` sinks.
+struct WriteOptions {
+    /// The size of the user-space buffer; the buffer is flushed when full.
+    size_t buffer_bytes{1 << 20};
+    /// If non-zero, the buffer is also flushed after this many lines.
+    size_t flush_lines{0};
+};
+
+/// Statistics returned by the buffered sinks.
+struct WriteStats {
+    size_t lines{0};
+    size_t bytes{0};
+    size_t flushes{0};
+    double seconds{0};
+
+    double bytes_per_second() const {
+	return seconds > 0 ? bytes / seconds : 0;
+    }
+};
+
+namespace detail {
+
+// Accumulate lines in a large buffer and flush them to a file
+// descriptor with `writev`. Lines too large for the remaining buffer
+// are written directly from the caller's memory without copying.
+class FdWriter {
+public:
+    // Write to the open file descriptor `fd` which is not closed.
+    FdWriter(int fd, const WriteOptions& options);
+
+    // Create or truncate `file` and write to it. Throws
+    // **std::runtime_error** if the file cannot be opened.
+    FdWriter(std::string_view file, const WriteOptions& options);
+
+    FdWriter(const FdWriter&) = delete;
+    FdWriter& operator=(const FdWriter&) = delete;
+
+    // Close the file if owned. Any unflushed lines are discarded
+    // unless `finish` has been called.
+    ~FdWriter();
+
+    void write(std::string_view line);
+
+    // Flush any buffered lines and return the statistics. Throws
+    // **std::runtime_error** if the write fails.
+    WriteStats finish();
+
+private:
+    void flush(std::string_view line = {}, bool newline = false);
+
+    int fd_;
+    bool owned_;
+    WriteOptions options_;
+    std::vector<char> buffer_;
+    size_t used_{0};
+    size_t pending_lines_{0};
+    WriteStats stats_;
+    std::chrono::steady_clock::time_point start_;
+};
+
+}; // detail
+
+/// Write lines from the supplied **Stream** `source` to the file
+/// descriptor `fd` through a large user-space buffer flushed with
+/// `writev`. The file descriptor is not closed.
+///
+/// Returns the number of lines and bytes written, the number of
+/// flushes and the elapsed time.
+WriteStats write_lines_fd(Stream auto source, int fd, WriteOptions options = {}) {
+    detail::FdWriter writer{fd, options};
+    for (const auto& line : source)
+	writer.write(std::string_view{line.data(), line.size()});
+    return writer.finish();
+}
+
+/// Write lines to the file descriptor `fd` through a large buffer.
+///
+/// \rst
+/// ```{code-block} cpp
+/// auto stats = str::alpha() | take(1000) | write_lines_fd(1, {.flush_lines = 100});
+/// ```
+/// \endrst
+inline auto write_lines_fd(int fd, WriteOptions options = {}) {
+    return [=]<Stream S>(S&& source) {
+	return write_lines_fd(std::forward<S>(source), fd, options);
+    };
+}
+
+/// Write lines from the supplied **Stream** `source` to `file`
+/// through a large user-space buffer flushed with `writev`.
+WriteStats write_lines_file(Stream auto source, std::string_view file, WriteOptions options = {}) {
+    detail::FdWriter writer{file, options};
+    for (const auto& line : source)
+	writer.write(std::string_view{line.data(), line.size()});
+    return writer.finish();
+}
+
+/// Write lines to `file` through a large buffer.
+inline auto write_lines_file(std::string_view file, WriteOptions options = {}) {
+    return [=]<Stream S>(S&& source) {
+	return write_lines_file(std::forward<S>(source), file, options);
+    };
+}
+
 }; // coro
@@ -6,13 +6,24 @@
 
 namespace coro {
 
-/// Return a generator that yields `count` number of **T**'s starting
-/// with `start` and incrementing by `step`.
+namespace detail {
+
 template<class T>
-Generator<const T&> iota(size_t count, T start = T{0}, T step = T{1}) {
+Generator<const T&> iota_generator(size_t count, T start, T step) {
     for (auto i = 0; i < count; ++i, start += step)
 	co_yield start;
     co_return;
 }
 
+}; // detail
+
+/// Return a generator that yields `count` number of **T**'s starting
+/// with `start` and incrementing by `step`.
+template<class T>
+Generator<const T&> iota(size_t count, T start = T{0}, T step = T{1}) {
+    auto g = detail::iota_generator<T>(count, start, step);
+    g.size_hint({ count, true });
+    return g;
+}
+
 }; // coro
@@ -0,0 +1,124 @@
+// Copyright 2024 by Mark Melton
+//
+
+#pragma once
+#include <functional>
+#include <optional>
+#include <vector>
+#include "coro/stream/util.h"
+#include "coro/stream/detail/loser_tree.h"
+
+namespace coro {
+
+/// Merge the sorted input Streams in `sources` into a single sorted
+/// Stream.
+///
+/// Each source must be sorted with respect to `comp`. The heads of the
+/// sources are kept in a loser tree so that each element costs about
+/// log2(k) comparisons for k sources. Equal elements are yielded in
+/// the order of their sources, so the merge is stable. Elements are
+/// yielded by reference from the sources without copying.
+///
+/// \tparam S An input source that satisfies the **Stream** concept.
+/// \tparam C A strict weak ordering of the Stream elements.
+template<Stream S, class C = std::less<>>
+Generator<stream_yield_t<S>> merge(std::vector<S> sources, C comp = C{}) {
+    using Iterator = decltype(std::begin(sources.front()));
+    using Sentinel = decltype(std::end(sources.front()));
+
+    using Y = stream_yield_t<S>;
+    using V = std::remove_cvref_t<Y>;
+
+    // The address of the current element of each source, or nullptr
+    // once it is exhausted, so that matches do not go through the
+    // iterators. Sources that yield by value have their current
+    // element held in `values`.
+    std::vector<Iterator> iters;
+    std::vector<Sentinel> ends;
+    std::vector<std::add_pointer_t<std::remove_reference_t<Y>>> heads(sources.size());
+    std::vector<std::optional<V>> values(std::is_reference_v<Y> ? 0 : sources.size());
+    iters.reserve(sources.size());
+    ends.reserve(sources.size());
+    auto load = [&](size_t idx) {
+	if (iters[idx] == ends[idx])
+	    heads[idx] = nullptr;
+	else if constexpr (std::is_reference_v<Y>) {
+	    // Bind first: std::addressof rejects an rvalue such as the
+	    // `T&&` of a Generator<T&&>.
+	    auto&& head = *iters[idx];
+	    heads[idx] = std::addressof(head);
+	} else
+	    heads[idx] = std::addressof(values[idx].emplace(*iters[idx]));
+    };
+    for (auto& source : sources) {
+	iters.emplace_back(std::begin(source));
+	ends.emplace_back(std::end(source));
+	load(iters.size() - 1);
+    }
+
+    // An exhausted source follows every live source and ties are won
+    // by the lower index, which needs only one comparison.
+    auto before = [&](size_t a, size_t b) {
+	if (heads[a] == nullptr)
+	    return false;
+	if (heads[b] == nullptr)
+	    return true;
+	if (a < b)
+	    return not comp(*heads[b], *heads[a]);
+	return bool(comp(*heads[a], *heads[b]));
+    };
+
+    detail::LoserTree tree;
+    tree.build(sources.size(), before);
+    while (not sources.empty()) {
+	auto idx = tree.winner();
+	if (heads[idx] == nullptr)
+	    break;
+	if constexpr (std::is_reference_v<Y>)
+	    co_yield static_cast<Y>(*heads[idx]);
+	else
+	    co_yield *heads[idx];
+	++iters[idx];
+	load(idx);
+	tree.replay(before);
+    }
+    co_return;
+}
+
+/// Merge the sorted input Streams in the tuple `sources` into a single
+/// sorted Stream (see above).
+///
+/// \tparam Ss Input sources that satisfy the **Stream** concept.
+/// \tparam C A strict weak ordering of the Stream elements.
+template<Stream... Ss, class C = std::less<>>
+requires (sizeof...(Ss) > 0)
+Generator<streams_yield_t<Ss...>> merge(std::tuple<Ss...> sources, C comp = C{}) {
+    using Y = streams_yield_t<Ss...>;
+    return merge(detail::as_generators<Y>(std::move(sources)), std::move(comp));
+}
+
+/// Merge sorted Streams ordered by `comp`.
+///
+/// Returns a function that accepts either a tuple or a
+/// **std::vector** of sorted input Streams and returns a new Stream
+/// that yields all of their elements in sorted order.
+///
+/// \rst
+/// ```{code-block} cpp
+/// std::vector<Generator<std::string&&>> shards;
+/// for (auto& file : files)
+///     shards.push_back(read_lines_plain(file));
+/// std::move(shards) | merge() | write_lines(output);
+///
+/// iota<int>(5, 0, 2) * iota<int>(5, 1, 2) | merge();
+/// // 0, 1, 2, 3, 4, 5, 6, 7, 8, 9
+/// ```
+/// \endrst
+template<class C = std::less<>>
+auto merge(C comp = C{}) {
+    return [=]<class V>(V&& sources) {
+	return merge(std::forward<V>(sources), comp);
+    };
+}
+
+}; // coro
@@ -0,0 +1,273 @@
+// Copyright 2024 by Mark Melton
+//
+
+#pragma once
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "coro/stream/par_transform.h"
+
+namespace coro {
+
+namespace detail {
+
+// A pool of worker threads each folding the batches it takes from a
+// shared bounded queue into its own private accumulator.
+template<class T, class A, class R>
+class ReducePool {
+public:
+    ReducePool(const A& init, R& reducer, size_t threads, size_t window)
+	: reducer_(reducer)
+	, window_(window)
+	, accumulators_(threads, init)
+	, exceptions_(threads) {
+	for (size_t i = 0; i < threads; ++i)
+	    workers_.emplace_back([this, i]() { run(i); });
+    }
+
+    ReducePool(const ReducePool&) = delete;
+    ReducePool& operator=(const ReducePool&) = delete;
+
+    ~ReducePool() {
+	stop();
+    }
+
+    // Return an empty batch, reusing one released by a worker if
+    // possible.
+    std::vector<T> batch() {
+	std::lock_guard lock{mutex_};
+	if (free_.empty())
+	    return {};
+	auto batch = std::move(free_.back());
+	free_.pop_back();
+	return batch;
+    }
+
+    // Queue `batch` waiting while `window` batches are already queued.
+    // Return false iff a worker has failed and no more batches will
+    // be folded.
+    bool submit(std::vector<T>&& batch) {
+	{
+	    std::unique_lock lock{mutex_};
+	    space_cv_.wait(lock, [&]() { return queue_.size() < window_ or failed_; });
+	    if (failed_)
+		return false;
+	    queue_.push_back(std::move(batch));
+	}
+	work_cv_.notify_one();
+	return true;
+    }
+
+    // Wait for all queued batches to be folded and return the
+    // accumulators. Rethrow the first exception thrown by `reducer`.
+    std::vector<A> finish() {
+	stop();
+	for (auto& exception : exceptions_)
+	    if (exception)
+		std::rethrow_exception(exception);
+	return std::move(accumulators_);
+    }
+
+private:
+    void stop() {
+	{
+	    std::lock_guard lock{mutex_};
+	    done_ = true;
+	}
+	work_cv_.notify_all();
+	for (auto& worker : workers_)
+	    if (worker.joinable())
+		worker.join();
+    }
+
+    void run(size_t index) {
+	auto& acc = accumulators_[index];
+	while (true) {
+	    std::vector<T> batch;
+	    {
+		std::unique_lock lock{mutex_};
+		work_cv_.wait(lock, [&]() { return done_ or not queue_.empty(); });
+		if (queue_.empty() or failed_)
+		    return;
+		batch = std::move(queue_.front());
+		queue_.pop_front();
+	    }
+	    space_cv_.notify_one();
+
+	    try {
+		for (auto& elem : batch)
+		    reducer_(acc, elem);
+	    } catch (...) {
+		exceptions_[index] = std::current_exception();
+		std::lock_guard lock{mutex_};
+		failed_ = true;
+		space_cv_.notify_all();
+		return;
+	    }
+
+	    batch.clear();
+	    std::lock_guard lock{mutex_};
+	    free_.push_back(std::move(batch));
+	}
+    }
+
+    R& reducer_;
+    size_t window_;
+    std::vector<A> accumulators_;
+    std::vector<std::exception_ptr> exceptions_;
+    std::mutex mutex_;
+    std::condition_variable work_cv_;
+    std::condition_variable space_cv_;
+    std::deque<std::vector<T>> queue_;
+    std::vector<std::vector<T>> free_;
+    bool done_{false};
+    bool failed_{false};
+    std::vector<std::thread> workers_;
+};
+
+inline constexpr size_t DefaultReduceBatch = 4096;
+
+}; // detail
+
+/// Reduce the elements of `source` on a pool of `threads` workers for
+/// an associative `reducer` and `combiner` preserving element order.
+///
+/// The elements are read on the calling thread and dispatched in
+/// batches of `batch` elements. Each batch is folded into a fresh copy
+/// of `init` with `reducer(A&, T&)` and the partial results are merged
+/// in input order with `combiner(A&, A&&)`, so `init` must be an
+/// identity for `combiner`. For commutative reductions
+/// `par_reduce_unordered` avoids the per-batch copy of `init`.
+/// `reducer` is invoked concurrently and must be safe to call from
+/// several threads. An exception thrown by `reducer` is rethrown.
+///
+/// \tparam S An input source that satisfies the **Stream** concept.
+template<Stream S, class A, class R, class C, class T = stream_value_t<S>>
+requires std::invocable<C&, A&, A&&>
+A par_reduce(S source, A init, R reducer, C combiner, size_t threads = 0,
+	     size_t batch = detail::DefaultReduceBatch) {
+    threads = detail::default_threads(threads);
+    auto window = detail::default_window(0, threads);
+    batch = std::max<size_t>(batch, 1);
+
+    auto fold = [&](std::vector<T>& elements) {
+	A acc = init;
+	for (auto& elem : elements)
+	    reducer(acc, elem);
+	return acc;
+    };
+    using F = decltype(fold);
+    detail::TransformPool<std::vector<T>, A, F> pool{fold, threads, window, true};
+
+    A result = init;
+    uint64_t submitted{0}, combined{0};
+    std::vector<T> elements;
+    elements.reserve(batch);
+    auto drain = [&](uint64_t limit) {
+	for (; submitted - combined > limit; ++combined) {
+	    combiner(result, std::move(pool.wait(combined)));
+	    pool.release(combined);
+	}
+    };
+
+    for (auto&& elem : source) {
+	elements.push_back(std::forward<decltype(elem)>(elem));
+	if (elements.size() == batch) {
+	    drain(window - 1);
+	    pool.submit(submitted++, std::move(elements));
+	    elements = {};
+	    elements.reserve(batch);
+	}
+    }
+    if (not elements.empty()) {
+	drain(window - 1);
+	pool.submit(submitted++, std::move(elements));
+    }
+    drain(0);
+    return result;
+}
+
+/// Reduce the elements of a Stream in parallel preserving order.
+///
+/// \rst
+/// ```{code-block} cpp
+/// auto text = read_lines_plain(file)
+///     | par_reduce(std::string{},
+///                  [](std::string& acc, const std::string& line) { acc += line; },
+///                  [](std::string& acc, std::string&& other) { acc += other; });
+/// ```
+/// \endrst
+template<class A, class R, class C>
+requires std::invocable<C&, A&, A&&>
+auto par_reduce(A init, R reducer, C combiner, size_t threads = 0,
+		size_t batch = detail::DefaultReduceBatch) {
+    return [=]<Stream S>(S&& source) {
+	return par_reduce<S>(std::forward<S>(source), init, reducer, combiner, threads, batch);
+    };
+}
+
+/// Reduce the elements of `source` on a pool of `threads` workers for
+/// a commutative and associative `reducer` and `combiner`.
+///
+/// Each worker folds whichever batches it takes into its own private
+/// copy of `init` with `reducer(A&, T&)`, so elements are combined in
+/// no particular order. The per-worker accumulators are merged with
+/// `combiner(A&, A&&)` at the end, so `init` must be an identity for
+/// `combiner`.
+///
+/// \tparam S An input source that satisfies the **Stream** concept.
+template<Stream S, class A, class R, class C, class T = stream_value_t<S>>
+requires std::invocable<C&, A&, A&&>
+A par_reduce_unordered(S source, A init, R reducer, C combiner, size_t threads = 0,
+		       size_t batch = detail::DefaultReduceBatch) {
+    threads = detail::default_threads(threads);
+    batch = std::max<size_t>(batch, 1);
+    detail::ReducePool<T, A, R> pool{init, reducer, threads, detail::default_window(0, threads)};
+
+    auto elements = pool.batch();
+    elements.reserve(batch);
+    for (auto&& elem : source) {
+	elements.push_back(std::forward<decltype(elem)>(elem));
+	if (elements.size() == batch) {
+	    if (not pool.submit(std::move(elements)))
+		break;
+	    elements = pool.batch();
+	    elements.reserve(batch);
+	}
+    }
+    if (not elements.empty())
+	pool.submit(std::move(elements));
+
+    auto accumulators = pool.finish();
+    A result = std::move(init);
+    for (auto& acc : accumulators)
+	combiner(result, std::move(acc));
+    return result;
+}
+
+/// Reduce the elements of a Stream in parallel in any order.
+///
+/// \rst
+/// ```{code-block} cpp
+/// auto histogram = samples
+///     | par_reduce_unordered(std::vector<size_t>(256),
+///                            [](auto& h, uint8_t x) { ++h[x]; },
+///                            [](auto& h, auto&& other) {
+///                                for (size_t i = 0; i < h.size(); ++i) h[i] += other[i];
+///                            });
+/// ```
+/// \endrst
+template<class A, class R, class C>
+requires std::invocable<C&, A&, A&&>
+auto par_reduce_unordered(A init, R reducer, C combiner, size_t threads = 0,
+			  size_t batch = detail::DefaultReduceBatch) {
+    return [=]<Stream S>(S&& source) {
+	return par_reduce_unordered<S>(std::forward<S>(source), init, reducer, combiner,
+				       threads, batch);
+    };
+}
+
+}; // coro
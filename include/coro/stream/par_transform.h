@@ -0,0 +1,255 @@
+// Copyright 2024 by Mark Melton
+//
+
+#pragma once
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+#include "coro/stream/util.h"
+
+namespace coro {
+
+namespace detail {
+
+// A pool of worker threads applying `func` to the elements submitted
+// into a fixed window of slots. Element `seq` occupies slot `seq %
+// window` from submission until it is released by the consumer.
+template<class T, class U, class F>
+class TransformPool {
+public:
+    struct Slot {
+	std::optional<T> input;
+	std::optional<U> output;
+	std::exception_ptr exception;
+	bool ready{false};
+    };
+
+    TransformPool(F& func, size_t threads, size_t window, bool ordered)
+	: func_(func)
+	, slots_(window)
+	, ordered_(ordered) {
+	for (size_t i = 0; i < threads; ++i)
+	    workers_.emplace_back([this]() { run(); });
+    }
+
+    TransformPool(const TransformPool&) = delete;
+    TransformPool& operator=(const TransformPool&) = delete;
+
+    ~TransformPool() {
+	{
+	    std::lock_guard lock{mutex_};
+	    stop_ = true;
+	}
+	work_cv_.notify_all();
+	for (auto& worker : workers_)
+	    worker.join();
+    }
+
+    size_t window() const {
+	return slots_.size();
+    }
+
+    // Submit `input` as element `seq` whose slot must be free.
+    template<class V>
+    void submit(uint64_t seq, V&& input) {
+	slot(seq).input.emplace(std::forward<V>(input));
+	{
+	    std::lock_guard lock{mutex_};
+	    pending_.push_back(seq);
+	}
+	work_cv_.notify_one();
+    }
+
+    // Wait for element `seq` to be transformed and return the
+    // result. Rethrow if the transformation threw.
+    U& wait(uint64_t seq) {
+	auto& s = slot(seq);
+	{
+	    std::unique_lock lock{mutex_};
+	    done_cv_.wait(lock, [&]() { return s.ready; });
+	}
+	if (s.exception)
+	    std::rethrow_exception(s.exception);
+	return *s.output;
+    }
+
+    // Wait for any submitted element to be transformed and return its
+    // sequence number. Only valid for an unordered pool.
+    uint64_t wait_any() {
+	std::unique_lock lock{mutex_};
+	done_cv_.wait(lock, [&]() { return not completed_.empty(); });
+	auto seq = completed_.front();
+	completed_.pop_front();
+	return seq;
+    }
+
+    // Free the slot for element `seq`.
+    void release(uint64_t seq) {
+	auto& s = slot(seq);
+	s.input.reset();
+	s.output.reset();
+	s.exception = nullptr;
+	s.ready = false;
+    }
+
+private:
+    Slot& slot(uint64_t seq) {
+	return slots_[seq % slots_.size()];
+    }
+
+    void run() {
+	while (true) {
+	    uint64_t seq;
+	    {
+		std::unique_lock lock{mutex_};
+		work_cv_.wait(lock, [&]() { return stop_ or not pending_.empty(); });
+		if (stop_)
+		    return;
+		seq = pending_.front();
+		pending_.pop_front();
+	    }
+
+	    auto& s = slot(seq);
+	    try {
+		s.output.emplace(func_(*s.input));
+	    } catch (...) {
+		s.exception = std::current_exception();
+	    }
+
+	    {
+		std::lock_guard lock{mutex_};
+		s.ready = true;
+		if (not ordered_)
+		    completed_.push_back(seq);
+	    }
+	    done_cv_.notify_one();
+	}
+    }
+
+    F& func_;
+    std::vector<Slot> slots_;
+    bool ordered_;
+    std::mutex mutex_;
+    std::condition_variable work_cv_;
+    std::condition_variable done_cv_;
+    std::deque<uint64_t> pending_;
+    std::deque<uint64_t> completed_;
+    bool stop_{false};
+    std::vector<std::thread> workers_;
+};
+
+inline size_t default_threads(size_t threads) {
+    return threads > 0 ? threads : std::max<size_t>(std::thread::hardware_concurrency(), 1);
+}
+
+inline size_t default_window(size_t window, size_t threads) {
+    return window > 0 ? window : 4 * threads;
+}
+
+}; // detail
+
+/// Return a generator that yields the elements from `source`
+/// transformed by `func` using a pool of `threads` workers.
+///
+/// At most `window` elements are in flight at once and the results
+/// are yielded in input order, so a slow element holds back the
+/// results behind it until it completes. `func` is invoked
+/// concurrently and must be safe to call from several threads. An
+/// exception thrown by `func` is rethrown when its element is reached.
+///
+/// \tparam S An input source that satisfies the **Stream** concept.
+/// \tparam F A function mapping **T&** to **U**.
+template<Stream S, class F,
+	 class T = stream_value_t<S>,
+	 class U = std::invoke_result_t<F&, T&>>
+Generator<U&&> par_transform(S source, F func, size_t threads, size_t window) {
+    threads = detail::default_threads(threads);
+    window = detail::default_window(window, threads);
+    detail::TransformPool<T, U, F> pool{func, threads, window, true};
+
+    uint64_t submitted{0}, yielded{0};
+    auto iter = std::begin(source);
+    auto end = std::end(source);
+    while (true) {
+	for (; submitted - yielded < window and iter != end; ++iter)
+	    pool.submit(submitted++, *iter);
+	if (yielded == submitted)
+	    break;
+	co_yield std::move(pool.wait(yielded));
+	pool.release(yielded++);
+    }
+    co_return;
+}
+
+/// Transform the elements of a Stream in parallel preserving order.
+///
+/// `threads` defaults to the hardware concurrency and `window` to
+/// four times the number of threads.
+///
+/// \rst
+/// ```{code-block} cpp
+/// read_lines_plain(file) | par_transform(parse, 8, 64) | apply(store);
+/// ```
+/// \endrst
+template<class F>
+auto par_transform(F func, size_t threads = 0, size_t window = 0) {
+    return [=]<Stream S>(S&& source) {
+	return par_transform<S>(std::forward<S>(source), func, threads, window);
+    };
+}
+
+/// Return a generator that yields the elements from `source`
+/// transformed by `func` using a pool of `threads` workers in
+/// whatever order the transformations complete.
+///
+/// \tparam S An input source that satisfies the **Stream** concept.
+/// \tparam F A function mapping **T&** to **U**.
+template<Stream S, class F,
+	 class T = stream_value_t<S>,
+	 class U = std::invoke_result_t<F&, T&>>
+Generator<U&&> par_transform_unordered(S source, F func, size_t threads, size_t window) {
+    threads = detail::default_threads(threads);
+    window = detail::default_window(window, threads);
+    detail::TransformPool<T, U, F> pool{func, threads, window, false};
+
+    // Slots are not freed in sequence order, so track the free slots
+    // explicitly.
+    std::vector<uint64_t> free(window);
+    for (size_t i = 0; i < window; ++i)
+	free[i] = window - 1 - i;
+
+    size_t in_flight{0};
+    auto iter = std::begin(source);
+    auto end = std::end(source);
+    while (true) {
+	for (; not free.empty() and iter != end; ++iter) {
+	    pool.submit(free.back(), *iter);
+	    free.pop_back();
+	    ++in_flight;
+	}
+	if (in_flight == 0)
+	    break;
+	auto seq = pool.wait_any();
+	co_yield std::move(pool.wait(seq));
+	pool.release(seq);
+	free.push_back(seq);
+	--in_flight;
+    }
+    co_return;
+}
+
+/// Transform the elements of a Stream in parallel yielding the
+/// results in completion order.
+template<class F>
+auto par_transform_unordered(F func, size_t threads = 0, size_t window = 0) {
+    return [=]<Stream S>(S&& source) {
+	return par_transform_unordered<S>(std::forward<S>(source), func, threads, window);
+    };
+}
+
+}; // coro
@@ -1,44 +1,100 @@
-// Copyright 2021, 2022 by Mark Melton
+// Copyright 2021, 2022, 2024 by Mark Melton
 //
 
 #pragma once
+#include <exception>
+#include <thread>
 #include "coro/stream/util.h"
-#include "core/cc/ring/ring.h"
-#include "core/cc/ring/claim.h"
-#include "core/cc/ring/processor.h"
-#include "core/cc/scoped_task.h"
+#include "coro/stream/detail/ring.h"
 
 namespace coro {
 
-template<Stream S>
-Generator<stream_value_t<S>&&> pipeline(S source) {
-    namespace ring = core::cc::ring;
-    
-    const size_t buffer_size = 256;
-    std::atomic<ring::sequence_t> final_idx{ring::FinalSequence};
-    ring::Ring<stream_value_t<S>> data{buffer_size};
-    ring::Processor<ring::SingleThreadClaimStrategy> producer{buffer_size};
-    ring::Processor<ring::SingleThreadClaimStrategy> consumer{buffer_size};
-    producer.add_write_barrier(consumer.cursor());
-    consumer.add_read_barrier(producer.cursor());
-
-    core::cc::scoped_task<void> producer_thread{[&]() {
-	while (source.next()) {
-	    auto idx = producer.claim();
-	    data[idx] = source();
-	    producer.publish(idx);
+/// Options for a `pipeline` stage.
+struct PipelineOptions {
+    /// The number of elements buffered between the stages (rounded up
+    /// to a power of two).
+    size_t capacity{256};
+    /// How the producer and consumer wait on a full or empty buffer.
+    WaitStrategy wait{WaitStrategy::Yield};
+    /// If non-null, the traffic counters for this stage are recorded here.
+    RingStats *stats{nullptr};
+};
+
+namespace detail {
+
+// Cancel the ring and join the producer when the consuming coroutine
+// is finished or destroyed.
+template<class T>
+struct PipelineJoin {
+    Ring<T>& ring;
+    std::thread& thread;
+
+    ~PipelineJoin() {
+	ring.cancel();
+	if (thread.joinable())
+	    thread.join();
+    }
+};
+
+}; // detail
+
+/// Return a generator that yields the elements from `source` which
+/// is run on its own thread.
+///
+/// Elements are moved (or copied if the source yields lvalues) into a
+/// bounded ring buffer by the producer thread and moved out by the
+/// consumer, so move-only element types are supported. If the
+/// consumer stops early, the producer is cancelled and joined. An
+/// exception thrown by `source` is rethrown to the consumer after the
+/// preceding elements have been yielded.
+///
+/// \tparam S An input source that satisfies the **Stream** concept.
+template<Stream S, class T = stream_value_t<S>>
+Generator<T&&> pipeline(S source, PipelineOptions options = {}) {
+    detail::Ring<T> ring{options.capacity, options.wait, options.stats};
+    std::exception_ptr exception;
+    std::thread producer{[&]() {
+	try {
+	    for (auto&& elem : source)
+		if (not ring.push(std::forward<decltype(elem)>(elem)))
+		    break;
+	} catch (...) {
+	    exception = std::current_exception();
 	}
-	final_idx.store(producer.cursor()->get());
+	ring.close();
     }};
+    detail::PipelineJoin<T> join{ring, producer};
 
-    while (consumer.cursor()->get() <= final_idx.load()) {
-	auto [begin, end] = consumer.claim_all();
-	for (auto idx = begin; idx < end; ++idx)
-	    co_yield data[idx];
-	consumer.publish({begin, end});
+    while (auto count = ring.acquire()) {
+	for (size_t idx = 0; idx < count; ++idx)
+	    co_yield std::move(ring[idx]);
+	ring.release(count);
     }
 
+    if (exception)
+	std::rethrow_exception(exception);
     co_return;
 }
 
+/// Run the preceding stages on their own thread.
+///
+/// Several `pipeline` boundaries can be inserted into a chain to run
+/// each segment on a separate thread.
+///
+/// \rst
+/// ```{code-block} cpp
+/// RingStats parse_stats;
+/// read_lines_plain(file)
+///     | pipeline()
+///     | transform(parse)
+///     | pipeline({.capacity = 1024, .wait = WaitStrategy::Block, .stats = &parse_stats})
+///     | apply(store);
+/// ```
+/// \endrst
+inline auto pipeline(PipelineOptions options = {}) {
+    return [=]<Stream S>(S&& source) {
+	return pipeline<S>(std::forward<S>(source), options);
+    };
+}
+
 }; // coro
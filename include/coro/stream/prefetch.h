@@ -0,0 +1,199 @@
+// Copyright (C) 2024 by Mark Melton
+//
+
+#pragma once
+#include "coro/stream/pipeline.h"
+
+namespace coro {
+
+/// Counters for a `prefetch` stage. In addition to the **RingStats**
+/// traffic and stall counters (`full_waits` counts producer stalls and
+/// `empty_waits` consumer stalls), the current bound on the buffer
+/// and the number of times it was grown are recorded.
+struct PrefetchStats : RingStats {
+    /// The number of elements currently admitted ahead of the consumer.
+    std::atomic<uint64_t> limit{0};
+    /// The number of bytes currently admitted ahead of the consumer
+    /// (zero if the buffer is bounded by elements only).
+    std::atomic<uint64_t> bytes{0};
+    /// The number of times the buffer was grown.
+    std::atomic<uint64_t> resizes{0};
+};
+
+/// Options for a `prefetch` stage.
+struct PrefetchOptions {
+    /// The number of elements initially buffered ahead of the consumer.
+    size_t capacity{64};
+    /// The number of elements the buffer may grow to if `adaptive`.
+    size_t max_capacity{4096};
+    /// If non-zero (and a size function is supplied), the number of
+    /// bytes initially buffered ahead of the consumer.
+    size_t bytes{0};
+    /// The number of bytes the buffer may grow to if `adaptive`.
+    size_t max_bytes{64 << 20};
+    /// If true, the bounds are doubled whenever the consumer stalls on
+    /// an empty buffer after the producer has stalled on a full one.
+    bool adaptive{true};
+    /// How the producer and consumer wait on a full or empty buffer.
+    WaitStrategy wait{WaitStrategy::Block};
+    /// If non-null, the counters for this stage are recorded here.
+    PrefetchStats *stats{nullptr};
+};
+
+namespace detail {
+
+// The size function of a `prefetch` bounded by elements only.
+struct Unweighed {};
+
+// An element buffered by a `prefetch` bounded by bytes along with
+// its size, so that exactly the bytes admitted are released.
+template<class T>
+struct Weighed {
+    T value;
+    size_t bytes;
+};
+
+}; // detail
+
+/// Return a generator that yields the elements from `source` which
+/// is run ahead of the consumer on its own thread.
+///
+/// Like `pipeline`, elements are moved through a ring buffer so
+/// move-only element types are supported, the producer is cancelled
+/// and joined if the consumer stops early, and an exception thrown by
+/// `source` is rethrown after the preceding elements are yielded.
+/// Unlike `pipeline`, the number of elements admitted ahead of the
+/// consumer starts at `options.capacity` and is doubled up to
+/// `options.max_capacity` (likewise `options.bytes` as measured by
+/// `size_fn` up to `options.max_bytes`) while both sides keep
+/// stalling, i.e. while the producer and consumer rates are too
+/// bursty for the current buffer.
+///
+/// \tparam S An input source that satisfies the **Stream** concept.
+/// \tparam F A function returning the size in bytes of an element.
+template<Stream S, class F = detail::Unweighed, class T = stream_value_t<S>>
+Generator<T&&> prefetch(S source, PrefetchOptions options = {}, F size_fn = {}) {
+    constexpr bool Weighted = not std::is_same_v<F, detail::Unweighed>;
+    using Element = std::conditional_t<Weighted, detail::Weighed<T>, T>;
+
+    PrefetchStats local_stats;
+    auto& stats = options.stats ? *options.stats : local_stats;
+    auto limit = std::max<size_t>(options.capacity, 1);
+    auto max_limit = options.adaptive ? std::max(limit, options.max_capacity) : limit;
+    uint64_t bytes = Weighted ? options.bytes : 0;
+    uint64_t max_bytes = options.adaptive ? std::max<uint64_t>(bytes, options.max_bytes) : bytes;
+
+    detail::Ring<Element> ring{max_limit, options.wait, &stats};
+    ring.set_limit(limit);
+    if (bytes > 0)
+	ring.set_weight_limit(bytes);
+    stats.limit.store(limit, std::memory_order_relaxed);
+    stats.bytes.store(bytes, std::memory_order_relaxed);
+    const bool byte_bound = bytes > 0;
+
+    std::exception_ptr exception;
+    std::thread producer{[&]() {
+	try {
+	    for (auto&& elem : source) {
+		if constexpr (Weighted) {
+		    size_t size = size_fn(std::as_const(elem));
+		    auto weight = byte_bound ? size : 0;
+		    if (not ring.push(Element{std::forward<decltype(elem)>(elem), size}, weight))
+			break;
+		} else if (not ring.push(std::forward<decltype(elem)>(elem))) {
+		    break;
+		}
+	    }
+	} catch (...) {
+	    exception = std::current_exception();
+	}
+	ring.close();
+    }};
+    detail::PipelineJoin<Element> join{ring, producer};
+
+    auto full_waits = stats.full_waits.load(std::memory_order_relaxed);
+    while (true) {
+	auto empty_waits = stats.empty_waits.load(std::memory_order_relaxed);
+	auto count = ring.acquire();
+	if (count == 0)
+	    break;
+
+	if ((limit < max_limit or bytes < max_bytes)
+	    and stats.empty_waits.load(std::memory_order_relaxed) != empty_waits) {
+	    auto waits = stats.full_waits.load(std::memory_order_relaxed);
+	    if (waits != full_waits) {
+		full_waits = waits;
+		limit = std::min(2 * limit, max_limit);
+		bytes = std::min(2 * bytes, max_bytes);
+		ring.set_limit(limit);
+		if (byte_bound)
+		    ring.set_weight_limit(bytes);
+		stats.limit.store(limit, std::memory_order_relaxed);
+		stats.bytes.store(bytes, std::memory_order_relaxed);
+		stats.resizes.store(stats.resizes.load(std::memory_order_relaxed) + 1,
+				    std::memory_order_relaxed);
+	    }
+	}
+
+	uint64_t weight = 0;
+	for (size_t idx = 0; idx < count; ++idx) {
+	    if constexpr (Weighted) {
+		weight += ring[idx].bytes;
+		co_yield std::move(ring[idx].value);
+	    } else {
+		co_yield std::move(ring[idx]);
+	    }
+	}
+	ring.release(count, byte_bound ? weight : 0);
+    }
+
+    if (exception)
+	std::rethrow_exception(exception);
+    co_return;
+}
+
+/// Run the preceding stages ahead of the consumer on their own
+/// thread, buffering up to `n` elements initially and growing the
+/// buffer while the producer and consumer both stall.
+///
+/// \rst
+/// ```{code-block} cpp
+/// PrefetchStats stats;
+/// auto g = read_lines_plain(file)
+///     | prefetch({.capacity = 16, .stats = &stats})
+///     | take(1000);
+/// for (auto&& line : g) parse(line);
+/// // stats.full_waits, stats.empty_waits, stats.limit, stats.resizes
+/// ```
+/// \endrst
+inline auto prefetch(PrefetchOptions options = {}) {
+    return [=]<Stream S>(S&& source) {
+	return prefetch<S>(std::forward<S>(source), options);
+    };
+}
+
+inline auto prefetch(size_t n) {
+    return prefetch(PrefetchOptions{.capacity = n});
+}
+
+/// Run the preceding stages ahead of the consumer on their own
+/// thread, buffering up to `bytes` bytes as measured by `size_fn`
+/// initially (and at least one element, however large). The number
+/// of elements is bounded only by `options.max_capacity`.
+///
+/// \rst
+/// ```{code-block} cpp
+/// auto g = read_lines_plain(file)
+///     | prefetch_bytes(1 << 20, [](const std::string& s) { return s.size(); });
+/// ```
+/// \endrst
+template<class F>
+auto prefetch_bytes(size_t bytes, F size_fn, PrefetchOptions options = {}) {
+    options.bytes = std::max<size_t>(bytes, 1);
+    options.capacity = options.max_capacity;
+    return [=]<Stream S>(S&& source) {
+	return prefetch<S, F>(std::forward<S>(source), options, size_fn);
+    };
+}
+
+}; // coro
@@ -2,7 +2,7 @@
 //
 
 #pragma once
-#include "coro/stream/util.h"
+#include "coro/stream/fuse.h"
 
 namespace coro {
 
@@ -10,8 +10,7 @@ namespace coro {
 // 
 template<Stream S, class A, class R>
 A reduce(S source, A accumulator, R&& reducer) {
-    for (auto&& elem : source)
-	reducer(accumulator, elem);
+    detail::for_each(source, [&](auto&& elem) { reducer(accumulator, elem); });
     return accumulator;
 }
 
@@ -6,12 +6,24 @@
 
 namespace coro {
 
-/// Return a generator that yields `value` exactly `count` times.
+namespace detail {
+
 template<class T>
-Generator<const T&> repeat(T value, size_t count = std::numeric_limits<size_t>::max()) {
+Generator<const T&> repeat_generator(T value, size_t count) {
     while (count--)
 	co_yield value;
     co_return;
 }
 
+}; // detail
+
+/// Return a generator that yields `value` exactly `count` times.
+template<class T>
+Generator<const T&> repeat(T value, size_t count = std::numeric_limits<size_t>::max()) {
+    auto g = detail::repeat_generator<T>(std::move(value), count);
+    if (count != SizeHint::Unknown)
+	g.size_hint({ count, true });
+    return g;
+}
+
 }; // coro
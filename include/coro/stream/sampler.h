@@ -2,17 +2,82 @@
 //
 
 #pragma once
+#include <span>
 #include "coro/stream/util.h"
+#include "coro/stream/detail/bulk_random.h"
+#include "coro/stream/sampler/context.h"
 
 namespace coro {
 
 template<class T>
 struct Sampler;
 
-// Return a generator that yields random **T**'s uniformly sampled.
+// A **Distribution** draws a sample when called with a random engine,
+// e.g. those in **coro::dist** or the standard distributions.
+template<class D>
+concept Distribution = requires (D d, Engine& engine) {
+    d(engine);
+};
+
+namespace detail {
+
+template<class... Args>
+constexpr bool is_distribution_args = sizeof...(Args) == 1
+    and (Distribution<std::remove_cvref_t<Args>> and ...);
+
+template<class... Args>
+struct is_substream_args : std::false_type { };
+
+template<class Arg, class... Args>
+struct is_substream_args<Arg, Args...> : std::is_same<std::remove_cvref_t<Arg>, Substream> { };
+
+// Yield **T**'s drawn from `dist` with words from the bulk engine.
+template<class T, class D>
+Generator<T> distribution_sampler(D dist) {
+    WordBuffer words;
+    while (true)
+	co_yield T(dist(words));
+    co_return;
+}
+
+// Fill `out` with **T**'s drawn from `dist` with words from the bulk
+// engine.
+template<class T, class D>
+void fill_distribution(std::span<T> out, D dist) {
+    WordBuffer words;
+    for (auto& value : out)
+	value = T(dist(words));
+}
+
+// Yield chunks of `size` **T**'s drawn from `dist`.
+template<class T, class D>
+Generator<std::span<T>> distribution_chunks(size_t size, D dist) {
+    WordBuffer words;
+    std::vector<T> buffer(size);
+    while (true) {
+	for (auto& value : buffer)
+	    value = T(dist(words));
+	co_yield std::span<T>{buffer};
+    }
+    co_return;
+}
+
+}; // detail
+
+// Return a generator that yields random **T**'s uniformly sampled, or
+// drawn from the distribution if the only argument is a
+// **Distribution**. If the first argument is a **Substream**, the
+// generator draws from that substream (see **SamplerContext**).
 template<class T, class... Args>
 Generator<T> sampler(Args&&... args) {
-    return Sampler<T>{}(std::forward<Args>(args)...);
+    if constexpr (detail::is_substream_args<Args...>::value)
+	return [](Substream substream, auto&&... rest) {
+	    return with_substream(substream, sampler<T>(std::forward<decltype(rest)>(rest)...));
+	}(std::forward<Args>(args)...);
+    else if constexpr (detail::is_distribution_args<Args...>)
+	return detail::distribution_sampler<T, std::remove_cvref_t<Args>...>(std::forward<Args>(args)...);
+    else
+	return Sampler<T>{}(std::forward<Args>(args)...);
 }
 
 // Return a generator that yields random **T's** uniformly sampled.
@@ -35,4 +100,35 @@ auto log_magnitude_sampler(Args&&... args) {
     return Sampler<T>{}.log_normal_magnitude(std::forward<Args>(args)...);
 }
 
+// Fill `out` with random **T's** uniformly sampled in bulk, or drawn
+// from the distribution if the only argument is a **Distribution**.
+template<class T, class... Args>
+void sample_fill(std::span<T> out, Args&&... args) {
+    if constexpr (detail::is_distribution_args<Args...>)
+	detail::fill_distribution<T, std::remove_cvref_t<Args>...>(out, std::forward<Args>(args)...);
+    else
+	Sampler<T>{}.fill(out, std::forward<Args>(args)...);
+}
+
+namespace chunk {
+
+// Return a generator that yields chunks of `size` random **T's**
+// uniformly sampled in bulk.
+template<class T, class... Args>
+Generator<std::span<T>> sampler(size_t size, Args&&... args) {
+    if constexpr (detail::is_substream_args<Args...>::value) {
+	return [size](Substream substream, auto&&... rest) {
+	    return with_substream(substream, sampler<T>(size, std::forward<decltype(rest)>(rest)...));
+	}(std::forward<Args>(args)...);
+    } else if constexpr (detail::is_distribution_args<Args...>) {
+	if (size == 0)
+	    throw std::runtime_error("sampler: expected a chunk size > 0");
+	return detail::distribution_chunks<T, std::remove_cvref_t<Args>...>(size, std::forward<Args>(args)...);
+    } else {
+	return Sampler<T>{}.chunked(size, std::forward<Args>(args)...);
+    }
+}
+
+}; // chunk
+
 }; // coro
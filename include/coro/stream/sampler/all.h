@@ -7,6 +7,8 @@
 #include "coro/stream/sampler/char.h"
 #include "coro/stream/sampler/chrono.h"
 #include "coro/stream/sampler/container.h"
+#include "coro/stream/sampler/context.h"
+#include "coro/stream/sampler/distribution.h"
 #include "coro/stream/sampler/floating.h"
 #include "coro/stream/sampler/integral.h"
 #include "coro/stream/sampler/pair.h"
@@ -0,0 +1,113 @@
+// Copyright (C) 2024 by Mark Melton
+//
+
+#pragma once
+#include <cstdint>
+#include <utility>
+#include "coro/stream/generator.h"
+#include "coro/stream/detail/bulk_random.h"
+
+namespace coro {
+
+/// One of the independent random streams of a **SamplerContext**.
+///
+/// A sampler created with `sampler<T>(substream, args...)` owns an
+/// engine seeded from `seed` on stream `index` (see **Engine**) and
+/// yields the same values every time, on whichever threads it is
+/// resumed.
+struct Substream {
+    uint64_t seed;
+    uint64_t index;
+};
+
+/// A seed from which reproducible, independent substreams are derived
+/// so that work split across threads or machines generates the same
+/// data as when it is done by one thread.
+///
+/// \rst
+/// ```{code-block} cpp
+/// SamplerContext ctx{42};
+/// // Shard `i` of the data set is identical whichever thread makes it.
+/// auto shard = sampler<int>(ctx.substream(i), 0, 100) | take(1'000'000);
+/// ```
+/// \endrst
+class SamplerContext {
+public:
+    explicit SamplerContext(uint64_t seed = EngineBase::DefaultSeed)
+	: seed_(seed) {
+    }
+
+    uint64_t seed() const {
+	return seed_;
+    }
+
+    /// Return substream `index`.
+    Substream substream(uint64_t index) const {
+	return { seed_, index };
+    }
+
+    /// Return an independent context for hierarchical splitting, e.g.
+    /// one per machine each with a substream per thread.
+    SamplerContext split(uint64_t index) const {
+	return SamplerContext{mix64(seed_ ^ mix64(index + SplitMix64::Gamma))};
+    }
+
+private:
+    uint64_t seed_;
+};
+
+namespace detail {
+
+// The engines of a substream.
+struct SubstreamState {
+    explicit SubstreamState(Substream substream)
+	: engine(substream.seed, substream.index) {
+    }
+
+    Engine engine;
+    BulkState bulk;
+};
+
+// Route the calling thread's `rng` and bulk engine to `state` until
+// destroyed. Must not be held across a suspension point.
+class SubstreamScope {
+public:
+    explicit SubstreamScope(SubstreamState& state)
+	: engine_(std::exchange(engine_override(), &state.engine))
+	, bulk_(exchange_bulk_state(&state.bulk)) {
+    }
+
+    SubstreamScope(const SubstreamScope&) = delete;
+    SubstreamScope& operator=(const SubstreamScope&) = delete;
+
+    ~SubstreamScope() {
+	engine_override() = engine_;
+	exchange_bulk_state(bulk_);
+    }
+
+private:
+    Engine *engine_;
+    BulkState *bulk_;
+};
+
+}; // detail
+
+/// Return a generator that yields the elements of `source` resuming it
+/// only with the engines of `substream` in effect, so that any
+/// sampler (e.g. `str::alpha()`) draws from `substream`.
+template<class R, class V>
+Generator<R, V> with_substream(Substream substream, Generator<R, V> source) {
+    detail::SubstreamState state{substream};
+    auto iter = [&]() {
+	detail::SubstreamScope scope{state};
+	return source.begin();
+    }();
+    while (iter != source.end()) {
+	co_yield *iter;
+	detail::SubstreamScope scope{state};
+	++iter;
+    }
+    co_return;
+}
+
+}; // coro
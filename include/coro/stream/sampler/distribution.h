@@ -0,0 +1,222 @@
+// Copyright (C) 2024 by Mark Melton
+//
+
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+#include "coro/stream/sampler.h"
+#include "coro/stream/detail/alias_table.h"
+
+namespace coro {
+
+namespace detail {
+
+// Return a double uniformly distributed in [0, 1) from the high 53
+// bits of `word`.
+inline double unit_interval(uint64_t word) {
+    return double(word >> 11) * 0x1.0p-53;
+}
+
+// The layers of the 256-layer ziggurat for the standard normal
+// density: x[i] is the right edge of layer i (x[0] is the width of the
+// base strip including its tail and x[256] = 0) and f[i] =
+// exp(-x[i]^2 / 2).
+struct NormalZiggurat {
+    static constexpr double R = 3.6541528853610088;
+    double x[257];
+    double f[257];
+};
+
+const NormalZiggurat& normal_ziggurat();
+
+}; // detail
+
+// Distributions for non-uniform samplers. Each is constructed once
+// (doing any precomputation) and then called with a
+// **UniformRandomBitGenerator** producing 64-bit words to draw a
+// sample, e.g. `sampler<uint64_t>(dist::Zipf{1'000'000, 1.1})`.
+namespace dist {
+
+/// The Zipf distribution over the ranks 1..`n` with exponent `s`:
+/// rank k is drawn with probability proportional to 1/k^s.
+///
+/// Sampled by rejection-inversion (Hörmann and Derflinger) with
+/// constants precomputed at construction, so each sample costs O(1)
+/// regardless of `n` and no harmonic sums are evaluated.
+class Zipf {
+public:
+    Zipf(uint64_t n, double s);
+
+    uint64_t n() const { return n_; }
+    double s() const { return s_; }
+
+    template<class G>
+    uint64_t operator()(G& g) const {
+	while (true) {
+	    auto u = h_integral_n_ + detail::unit_interval(g()) * (h_integral_x1_ - h_integral_n_);
+	    auto x = h_integral_inverse(u);
+	    auto k = std::clamp<double>(std::floor(x + 0.5), 1, n_);
+	    if (k - x <= threshold_ or u >= h_integral(k + 0.5) - h(k))
+		return uint64_t(k);
+	}
+    }
+
+private:
+    double h(double x) const;
+    double h_integral(double x) const;
+    double h_integral_inverse(double x) const;
+
+    uint64_t n_;
+    double s_;
+    double h_integral_x1_;
+    double h_integral_n_;
+    double threshold_;
+};
+
+/// The exponential distribution with rate `lambda`.
+class Exponential {
+public:
+    explicit Exponential(double lambda = 1.0);
+
+    template<class G>
+    double operator()(G& g) const {
+	return -std::log1p(-detail::unit_interval(g())) * scale_;
+    }
+
+private:
+    double scale_;
+};
+
+/// The normal distribution with `mean` and `stddev`.
+///
+/// Sampled with a 256-layer ziggurat (Marsaglia and Tsang): almost
+/// every sample costs one word, one table lookup and one multiply.
+class Normal {
+public:
+    explicit Normal(double mean = 0.0, double stddev = 1.0)
+	: mean_(mean)
+	, stddev_(stddev)
+	, zig_(&detail::normal_ziggurat()) {
+    }
+
+    template<class G>
+    double operator()(G& g) const {
+	return mean_ + stddev_ * standard(g);
+    }
+
+private:
+    template<class G>
+    double standard(G& g) const {
+	const auto& x = zig_->x;
+	const auto& f = zig_->f;
+	while (true) {
+	    // The low byte selects the layer and the high 52 bits give
+	    // a signed position within it.
+	    auto bits = g();
+	    auto i = bits & 0xff;
+	    auto u = 2 * (double(bits >> 12) * 0x1.0p-52) - 1;
+	    auto z = u * x[i];
+	    if (std::abs(z) < x[i + 1])
+		return z;
+	    if (i == 0)
+		return tail(g, u < 0);
+	    if (f[i + 1] + (f[i] - f[i + 1]) * detail::unit_interval(g()) < std::exp(-z * z / 2))
+		return z;
+	}
+    }
+
+    template<class G>
+    double tail(G& g, bool negative) const {
+	constexpr auto R = detail::NormalZiggurat::R;
+	double x, y;
+	do {
+	    x = std::log1p(-detail::unit_interval(g())) / R;
+	    y = std::log1p(-detail::unit_interval(g()));
+	} while (-2 * y < x * x);
+	return negative ? x - R : R - x;
+    }
+
+    double mean_;
+    double stddev_;
+    const detail::NormalZiggurat *zig_;
+};
+
+/// The Poisson distribution with `mean`.
+///
+/// Sampled by inversion for small means and by transformed rejection
+/// with squeeze (Hörmann's PTRS) otherwise, so the expected cost is
+/// O(1) for any mean.
+class Poisson {
+public:
+    explicit Poisson(double mean = 1.0);
+
+    template<class G>
+    uint64_t operator()(G& g) const {
+	if (mean_ < Threshold) {
+	    uint64_t k{0};
+	    auto p = exp_mean_;
+	    auto cdf = p;
+	    auto u = detail::unit_interval(g());
+	    while (u > cdf and p > 0) {
+		++k;
+		p *= mean_ / k;
+		cdf += p;
+	    }
+	    return k;
+	}
+
+	while (true) {
+	    auto u = detail::unit_interval(g()) - 0.5;
+	    auto v = detail::unit_interval(g());
+	    auto us = 0.5 - std::abs(u);
+	    auto k = std::floor((2 * a_ / us + b_) * u + mean_ + 0.43);
+	    if (us >= 0.07 and v <= vr_)
+		return uint64_t(k);
+	    if (k < 0 or (us < 0.013 and v > us))
+		continue;
+	    if (std::log(v) + log_inv_alpha_ - std::log(a_ / (us * us) + b_)
+		<= -mean_ + k * log_mean_ - std::lgamma(k + 1))
+		return uint64_t(k);
+	}
+    }
+
+private:
+    static constexpr double Threshold = 10;
+
+    double mean_;
+    double exp_mean_;
+    double log_mean_;
+    double a_, b_, vr_, log_inv_alpha_;
+};
+
+/// An empirical distribution over `values` drawn with probability
+/// proportional to `weights` using an alias table, so each sample
+/// costs O(1) however many values there are.
+class Empirical {
+public:
+    Empirical(std::vector<double> values, std::vector<double> weights);
+
+    /// Load the distribution from a text `file` with one value per
+    /// line optionally followed by its weight (default 1), so that
+    /// either a histogram or raw observations can be given. Blank
+    /// lines and lines starting with `#` are ignored.
+    static Empirical load(std::string_view file);
+
+    const std::vector<double>& values() const { return values_; }
+
+    template<class G>
+    double operator()(G& g) const {
+	return values_[table_.sample(g())];
+    }
+
+private:
+    std::vector<double> values_;
+    detail::AliasTable table_;
+};
+
+}; // dist
+
+}; // coro
@@ -3,7 +3,7 @@
 
 #pragma once
 #include "coro/stream/sampler.h"
-#include "coro/stream/detail/random.h"
+#include "coro/stream/detail/bulk_random.h"
 
 namespace coro {
 
@@ -23,6 +23,34 @@ struct Sampler<T> {
 	co_return;
     }
 
+    // Fill `out` with values uniformly sampled from [min, max] using
+    // the vectorized bulk engine and Lemire's bounded integers.
+    void fill(std::span<T> out,
+	      T min = std::numeric_limits<T>::min(),
+	      T max = std::numeric_limits<T>::max()) const {
+	detail::fill_uniform(out, min, max);
+    }
+
+    // Return a generator that yields chunks of `size` values uniformly
+    // sampled from [min, max] by `fill`. Throws **std::runtime_error** if
+    // `size` is zero.
+    Generator<std::span<T>> chunked(size_t size = 1024,
+				    T min = std::numeric_limits<T>::min(),
+				    T max = std::numeric_limits<T>::max()) const {
+	if (size == 0)
+	    throw std::runtime_error("sampler: expected a chunk size > 0");
+	return chunked_generator(size, min, max);
+    }
+
+    static Generator<std::span<T>> chunked_generator(size_t size, T min, T max) {
+	std::vector<T> buffer(size);
+	while (true) {
+	    detail::fill_uniform(std::span<T>{buffer}, min, max);
+	    co_yield std::span<T>{buffer};
+	}
+	co_return;
+    }
+
     static size_t clamp(size_t n, size_t min, size_t max) {
 	return std::min(std::max(n, min), max);
     }
@@ -0,0 +1,106 @@
+// Copyright (C) 2024 by Mark Melton
+//
+
+#pragma once
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <type_traits>
+#include <utility>
+#include "coro/stream/fuse.h"
+#include "coro/stream/detail/frame_pool.h"
+
+namespace coro {
+
+namespace detail {
+
+template<class T>
+struct is_generator : std::false_type { };
+
+template<class R, class V>
+struct is_generator<Generator<R, V>> : std::true_type { };
+
+template<class T>
+constexpr bool is_generator_v = is_generator<std::remove_cvref_t<T>>::value;
+
+}; // detail
+
+/// Inline storage of `Bytes` for the coroutine frames of generators
+/// that are created and consumed within one scope.
+///
+/// While a **ScopedFrames** is alive, the frames of generators created
+/// on the constructing thread are placed in its buffer, typically on
+/// the stack, rather than on the heap or in the frame pool. A frame
+/// that does not fit falls back to the frame pool, which is counted by
+/// `fallbacks()`. Every generator frame placed in the buffer must be
+/// destroyed before the **ScopedFrames**, including the nested frames
+/// of a recursive or lazy generator created earlier but iterated in
+/// the scope; otherwise the process is aborted rather than left with
+/// dangling frames. Scopes may be nested; the innermost is used.
+///
+/// \rst
+/// ```{code-block} cpp
+/// ScopedFrames<2048> frames;
+/// auto sum = iota<int>(100) | transform(square) | reduce(0, add);
+/// ```
+/// \endrst
+template<std::size_t Bytes = 4096>
+class ScopedFrames {
+public:
+    static_assert(Bytes >= 256, "scoped frames: the buffer cannot hold a frame");
+    static_assert(Bytes % __STDCPP_DEFAULT_NEW_ALIGNMENT__ == 0,
+		  "scoped frames: the buffer size must be a multiple of the frame alignment");
+
+    ScopedFrames() noexcept
+	: arena_(storage_, Bytes)
+	, previous_(std::exchange(detail::frame_arena(), &arena_)) {
+    }
+
+    ScopedFrames(const ScopedFrames&) = delete;
+    ScopedFrames& operator=(const ScopedFrames&) = delete;
+
+    ~ScopedFrames() {
+	detail::frame_arena() = previous_;
+	if (arena_.live() != 0) {
+	    std::fputs("ScopedFrames: a generator frame outlives its scope\n", stderr);
+	    std::abort();
+	}
+    }
+
+    /// Return the most bytes of the buffer in use at once.
+    std::size_t high_water() const { return arena_.high_water(); }
+
+    /// Return the number of frames that did not fit in the buffer.
+    std::size_t fallbacks() const { return arena_.fallbacks(); }
+
+private:
+    alignas(__STDCPP_DEFAULT_NEW_ALIGNMENT__) std::byte storage_[Bytes];
+    detail::FrameArena arena_;
+    detail::FrameArena *previous_;
+};
+
+/// Return the result of calling `function` with the frames of the
+/// generators it creates placed in a **ScopedFrames<Bytes>**.
+///
+/// This suits a chain ending in a terminal operator (e.g. `reduce`,
+/// `sapply`, `collect` or `write_lines`) so that it runs without
+/// allocating. The result must not be a stream whose frames would
+/// outlive the scope, which is checked at compile time.
+///
+/// \rst
+/// ```{code-block} cpp
+/// auto sum = scoped([&]() {
+///     return iota<int>(n) | filter(odd) | reduce(0, add);
+/// });
+/// ```
+/// \endrst
+template<std::size_t Bytes = 4096, class F>
+decltype(auto) scoped(F&& function) {
+    using R = std::remove_cvref_t<std::invoke_result_t<F&>>;
+    static_assert(not detail::is_generator_v<R> and not detail::is_fused_v<R>,
+		  "scoped: a generator must not outlive the frames of its scope");
+    ScopedFrames<Bytes> frames;
+    return function();
+}
+
+}; // coro
@@ -35,7 +35,39 @@ Generator<streams_yield_t<Ss...>> sequence(std::tuple<Ss...> tup) {
 
 #undef APPLY_NTH
 
-/// Sequence the elements from the preceeding array of generators.
+namespace detail {
+
+template<Stream S>
+Generator<stream_yield_t<S>> sequence_generator(std::vector<S> sources) {
+    for (auto& source : sources)
+	for (auto&& elem : source)
+	    co_yield elem;
+    co_return;
+}
+
+}; // detail
+
+/// Return a generator that yields all the elements from each of the
+/// runtime number of `sources` in turn.
+///
+/// \tparam S An input source that satisfies the **Stream** concept.
+template<Stream S>
+Generator<stream_yield_t<S>> sequence(std::vector<S> sources) {
+    SizeHint hint{0, true};
+    for (const auto& source : sources) {
+	auto h = stream_size_hint(source);
+	if (not h.known())
+	    hint = {};
+	if (hint.known())
+	    hint = { hint.count + h.count, hint.exact and h.exact };
+    }
+    auto g = detail::sequence_generator<S>(std::move(sources));
+    g.size_hint(hint);
+    return g;
+}
+
+/// Sequence the elements from the preceeding tuple or **std::vector**
+/// of generators.
 ///
 /// *Returns:* **Generator<...>** A generator that yields elements from the underlying
 /// generators starting with all the elements from the first generator before proceeding to
@@ -2,15 +2,20 @@
 //
 
 #pragma once
+#include <algorithm>
 #include "coro/stream/util.h"
 
 namespace coro {
 
-/// Return a generator that yields the first `count` elements (or until
-/// exhaustion) from the supplied `generator`.
+namespace detail {
+
 template<Stream S>
-Generator<stream_yield_t<S>> take(S source, size_t count) {
-    if (count > 0) {
+Generator<stream_yield_t<S>> take_generator(S source, size_t count) {
+    if constexpr (ContiguousStream<S>) {
+	auto data = std::data(source);
+	for (size_t i = 0, n = std::min(count, stream_size(source)); i < n; ++i)
+	    co_yield data[i];
+    } else if (count > 0) {
 	for (auto&& elem : source) {
 	    co_yield elem;
 	    if (--count == 0)
@@ -20,6 +25,18 @@ Generator<stream_yield_t<S>> take(S source, size_t count) {
     co_return;
 }
 
+}; // detail
+
+/// Return a generator that yields the first `count` elements (or until
+/// exhaustion) from the supplied `generator`.
+template<Stream S>
+Generator<stream_yield_t<S>> take(S source, size_t count) {
+    auto hint = stream_size_hint(source).limit(count);
+    auto g = detail::take_generator<S>(std::forward<S>(source), count);
+    g.size_hint(hint);
+    return g;
+}
+
 /// Take the first `count` elements from the preceeding generator.
 ///
 /// Usage: *sampler<int>() | take(10)*
@@ -6,13 +6,33 @@
 
 namespace coro {
 
+namespace detail {
+
+template<Stream S, class F, class U>
+Generator<U&&> transform_generator(S source, F func) {
+    if constexpr (ContiguousStream<S>) {
+	auto data = std::data(source);
+	for (size_t i = 0, n = stream_size(source); i < n; ++i)
+	    co_yield func(data[i]);
+    } else {
+	for (auto&& elem : source)
+	    co_yield func(std::forward<decltype(elem)>(elem));
+    }
+    co_return;
+}
+
+}; // detail
+
 /// Return a generator that yields the elements from the supplied `generator` transformed
 /// by the given function `func` that maps **T** to **U**.
+///
+/// `func` is stored in the generator, so it may safely be a temporary.
 template<Stream S, class F, class U = std::invoke_result_t<F, stream_value_t<S>>>
-Generator<U&&> transform(S source, F&& func) {
-    for (auto&& elem : source)
-	co_yield func(elem);
-    co_return;
+Generator<U&&> transform(S source, F func) {
+    auto hint = stream_size_hint(source);
+    auto g = detail::transform_generator<S, F, U>(std::forward<S>(source), std::move(func));
+    g.size_hint(hint);
+    return g;
 }
 
 /// Transform the elements from the preceeding generator using the supplied `func`.
@@ -22,9 +42,9 @@ Generator<U&&> transform(S source, F&& func) {
 ///
 /// *sampler<int>(0, 10) | transform([](int n) { return n + 10; })*
 template<class F>
-auto transform(F&& function) {
-    return [f = std::forward<F>(function)]<Stream S>(S&& source) mutable {
-	return transform<S>(std::forward<S>(source), std::forward<F>(f));
+auto transform(F function) {
+    return [=]<Stream S>(S&& source) {
+	return transform<S>(std::forward<S>(source), function);
     };
 }
 
@@ -1,25 +1,60 @@
-// Copyright 2021, 2022 by Mark Melton
+// Copyright 2021, 2022, 2024 by Mark Melton
 //
 
 #pragma once
+#include <functional>
 #include <set>
 #include "coro/stream/util.h"
+#include "coro/stream/detail/bloom.h"
+#include "coro/stream/detail/flat_map.h"
 
 namespace coro {
 
+namespace detail {
+
+struct Identity {
+    template<class T>
+    const T& operator()(const T& value) const {
+	return value;
+    }
+};
+
+template<class S, class F>
+using unique_key_t = std::decay_t<std::invoke_result_t<F&, stream_value_t<S>&>>;
+
+template<class K>
+concept Hashable = requires(const K& key) {
+    { std::hash<K>{}(key) } -> std::convertible_to<size_t>;
+};
+
+// The hasher for keys without a **std::hash** specialization, which
+// are kept ordered instead.
+struct Unhashed {};
+
+template<class K>
+using unique_hash_t = std::conditional_t<Hashable<K>, std::hash<K>, Unhashed>;
+
+}; // detail
+
 /// Return a generator that yields the elements from the supplied `generator` filtering
 /// them to be unique with respect to the given `key` function.
-template<Stream S, class F>
-Generator<stream_yield_t<S>> unique(S source, F key) {
-    using T = stream_value_t<S>;
-    using K = std::invoke_result_t<F, T>;
-    std::set<K> s;
-    for (auto&& element : source) {
-	auto k = key(element);
-	if (not s.contains(k)) {
-	    co_yield element;
-	    s.insert(k);
-	}
+///
+/// The keys seen so far are kept in an open-addressing hash set
+/// hashed by `hash`, or in a **std::set** if the keys have no
+/// **std::hash** and no `hash` is given.
+template<Stream S, class F, class H = detail::unique_hash_t<detail::unique_key_t<S, F>>>
+Generator<stream_yield_t<S>> unique(S source, F key, H hash = H{}) {
+    using K = detail::unique_key_t<S, F>;
+    if constexpr (std::is_same_v<H, detail::Unhashed>) {
+	std::set<K> seen;
+	for (auto&& element : source)
+	    if (seen.insert(key(element)).second)
+		co_yield element;
+    } else {
+	detail::FlatSet<K, H> seen{16, std::move(hash)};
+	for (auto&& element : source)
+	    if (seen.insert(key(element)))
+		co_yield element;
     }
     co_return;
 }
@@ -32,11 +67,94 @@ Generator<stream_yield_t<S>> unique(S source, F key) {
 /// **G** filtered with respect to the given `key` function.
 ///
 /// *sampler<int>(0, 100) | unique([](int n) { return n % 11; })*
-template<class F>
-auto unique(F key) {
+template<class F = detail::Identity>
+auto unique(F key = F{}) {
     return [=]<Stream S>(S&& source) {
 	return unique<S>(std::forward<S>(source), std::move(key));
     };
 }
 
+/// Filter elements to be unique with respect to `key` using the
+/// hasher `hash` for the keys.
+template<class F, class H>
+requires (not Stream<F>)
+auto unique(F key, H hash) {
+    return [=]<Stream S>(S&& source) {
+	return unique<S, F, H>(std::forward<S>(source), std::move(key), std::move(hash));
+    };
+}
+
+/// Return a generator that yields the elements from `source` whose key
+/// is not among the `capacity` most recently seen keys.
+///
+/// Memory is bounded by `capacity` keys. A key that keeps reappearing
+/// stays recent and is suppressed; a key not seen for `capacity`
+/// distinct keys is forgotten and will be yielded again.
+template<Stream S, class F, class H = std::hash<detail::unique_key_t<S, F>>>
+Generator<stream_yield_t<S>> unique_lru(S source, F key, size_t capacity, H hash = H{}) {
+    using K = detail::unique_key_t<S, F>;
+    detail::LruSet<K, H> recent{capacity, std::move(hash)};
+    for (auto&& element : source)
+	if (recent.insert(key(element)))
+	    co_yield element;
+    co_return;
+}
+
+/// Filter elements to be unique among the `capacity` most recently
+/// seen keys.
+///
+/// \rst
+/// ```{code-block} cpp
+/// read_lines_plain(log) | unique_lru([](auto& line) { return request_id(line); }, 1 << 16);
+/// ```
+/// \endrst
+template<class F>
+auto unique_lru(F key, size_t capacity) {
+    return [=]<Stream S>(S&& source) {
+	return unique_lru<S>(std::forward<S>(source), std::move(key), capacity);
+    };
+}
+
+/// Options for `unique_bloom`.
+struct BloomOptions {
+    /// The expected number of distinct keys.
+    size_t expected{1 << 20};
+    /// The target false positive rate at `expected` keys.
+    double false_positive{0.01};
+    /// If non-zero, the filter size in bytes overriding `expected` and
+    /// `false_positive`.
+    size_t memory_bytes{0};
+};
+
+/// Return a generator that yields the elements from `source` whose key
+/// has (probably) not been seen before, using a Bloom filter.
+///
+/// Memory is fixed when the filter is created and no duplicate is ever
+/// yielded, but with probability about `false_positive` a new key is
+/// mistaken for a duplicate and its element is dropped. The rate
+/// rises once more than `expected` distinct keys have been seen.
+template<Stream S, class F, class H = std::hash<detail::unique_key_t<S, F>>>
+Generator<stream_yield_t<S>> unique_bloom(S source, F key, BloomOptions options = {}, H hash = H{}) {
+    detail::BloomFilter filter{options.expected, options.false_positive, options.memory_bytes};
+    for (auto&& element : source)
+	if (filter.insert(mix64(hash(key(element)))))
+	    co_yield element;
+    co_return;
+}
+
+/// Filter elements to be (probably) unique with respect to `key`
+/// in bounded memory.
+///
+/// \rst
+/// ```{code-block} cpp
+/// records | unique_bloom(record_id, {.expected = 100'000'000, .false_positive = 1e-4});
+/// ```
+/// \endrst
+template<class F>
+auto unique_bloom(F key, BloomOptions options = {}) {
+    return [=]<Stream S>(S&& source) {
+	return unique_bloom<S>(std::forward<S>(source), std::move(key), options);
+    };
+}
+
 }; // coro
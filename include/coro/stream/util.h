@@ -10,6 +10,12 @@ namespace coro {
 
 // The **stream_traits** template class is an opt-in mechanism for
 // adapting a class to meet the **Stream** requirements.
+//
+// Besides `value_type` and `yield_type`, a specialization may declare
+// the capabilities of the source that let operators avoid resuming a
+// coroutine per element: a static `size` member if the number of
+// elements is known up front, `random_access` if they can be indexed,
+// and `contiguous` if they are laid out in memory as by `std::data`.
 template<class T>
 struct stream_traits : public std::false_type { };
 
@@ -17,24 +23,37 @@ template<class T, class U>
 struct stream_traits<Generator<T, U>> : public std::true_type {
     using value_type = typename Generator<T,U>::value_type;
     using yield_type = typename Generator<T,U>::reference_type;
+    static SizeHint size_hint(const Generator<T,U>& g) { return g.size_hint(); }
 };
 
 template<class T>
 struct stream_traits<std::vector<T>> : public std::true_type {
     using value_type = T;
     using yield_type = T&;
+    static constexpr bool random_access = true;
+    static constexpr bool contiguous = not std::is_same_v<T, bool>;
+    static size_t size(const std::vector<T>& v) { return v.size(); }
+    static SizeHint size_hint(const std::vector<T>& v) { return { v.size(), true }; }
 };
 
 template<class T>
 struct stream_traits<const std::vector<T>> : public std::true_type {
     using value_type = T;
     using yield_type = const T&;
+    static constexpr bool random_access = true;
+    static constexpr bool contiguous = not std::is_same_v<T, bool>;
+    static size_t size(const std::vector<T>& v) { return v.size(); }
+    static SizeHint size_hint(const std::vector<T>& v) { return { v.size(), true }; }
 };
 
 template<class T>
 struct stream_traits<coro::detail::Fixed<std::vector<T>>> : public std::true_type {
     using value_type = T;
     using yield_type = T&;
+    static constexpr bool random_access = true;
+    static constexpr bool contiguous = not std::is_same_v<T, bool>;
+    static size_t size(const std::vector<T>& v) { return v.size(); }
+    static SizeHint size_hint(const std::vector<T>& v) { return { v.size(), true }; }
 };
 
 // Evaluates to true if class `T` has a **stream_traits** specialization.
@@ -48,6 +67,44 @@ using stream_value_t = typename stream_traits<std::remove_reference_t<T>>::value
 template<class T>
 using stream_yield_t = typename stream_traits<std::remove_reference_t<T>>::yield_type;
 
+// Return the number of elements `source` will yield as reported by
+// the optional static `size_hint` member of its **stream_traits**.
+template<class T>
+SizeHint stream_size_hint(const T& source) {
+    using Traits = stream_traits<std::remove_cvref_t<T>>;
+    if constexpr (requires { Traits::size_hint(source); })
+	return Traits::size_hint(source);
+    else
+	return {};
+}
+
+// Evaluates to true if the number of elements of **Stream** `T` is
+// known before it is iterated.
+template<class T>
+constexpr bool is_sized_stream_v = requires (const std::remove_cvref_t<T>& source) {
+    stream_traits<std::remove_cvref_t<T>>::size(source);
+};
+
+// Evaluates to true if the elements of **Stream** `T` can be indexed.
+template<class T>
+constexpr bool is_random_access_stream_v = requires {
+    requires stream_traits<std::remove_cvref_t<T>>::random_access;
+};
+
+// Evaluates to true if the elements of **Stream** `T` are contiguous
+// in memory, so that an operator can run a direct (vectorizable) index
+// loop over `std::data(source)`.
+template<class T>
+constexpr bool is_contiguous_stream_v = requires {
+    requires stream_traits<std::remove_cvref_t<T>>::contiguous;
+};
+
+// Return the number of elements of the sized stream `source`.
+template<class T>
+size_t stream_size(const T& source) {
+    return stream_traits<std::remove_cvref_t<T>>::size(source);
+}
+
 namespace detail {
 template<class T, bool l, bool r, bool c>
 struct compatible_type_helper;
@@ -94,12 +151,45 @@ concept Stream = requires (T t) {
 };
 
 namespace detail {
+
+// Return a generator that yields the elements of `source` as `Y`, for
+// adapting the members of a tuple of Streams to a common type.
+template<class Y, class S>
+Generator<Y> as_generator(S source) {
+    for (auto&& elem : source)
+	co_yield elem;
+    co_return;
+}
+
+// Return a vector of generators yielding the elements of each of the
+// Streams in `tuple` as `Y`.
+template<class Y, class... Ss>
+std::vector<Generator<Y>> as_generators(std::tuple<Ss...>&& tuple) {
+    std::vector<Generator<Y>> generators;
+    generators.reserve(sizeof...(Ss));
+    [&]<size_t... Is>(std::index_sequence<Is...>) {
+	(generators.push_back(as_generator<Y, Ss>(std::get<Is>(std::move(tuple)))), ...);
+    }(std::index_sequence_for<Ss...>{});
+    return generators;
+}
+
 template<class T> struct is_tuple_of_stream: std::false_type { };
 template<Stream... Ss> struct is_tuple_of_stream<std::tuple<Ss...>>: std::true_type { };
 }; // detail
 
 template<class T>
 concept TupleOfStream = detail::is_tuple_of_stream<T>::value;
+
+// The **SizedStream**, **RandomAccessStream** and **ContiguousStream**
+// concepts refine **Stream** by the capabilities of its traits.
+template<class T>
+concept SizedStream = Stream<T> and is_sized_stream_v<T>;
+
+template<class T>
+concept RandomAccessStream = SizedStream<T> and is_random_access_stream_v<T>;
+
+template<class T>
+concept ContiguousStream = RandomAccessStream<T> and is_contiguous_stream_v<T>;
     
 // Requires that `T` has correpsonding free function `getline`.
 template<class T>
@@ -2,6 +2,10 @@
 //
 
 #pragma once
+#include <algorithm>
+#include <span>
+#include <stdexcept>
+#include <vector>
 #include "coro/stream/util.h"
 #include "coro/stream/adapt.h"
 #include "core/tuple/map.h"
@@ -9,13 +13,10 @@
 
 namespace coro {
 
-/// Zip the elements from the given tuple of generators.
-///
-/// *Returns:* **Generator<std::tuple<...>>** A generator that yields **std::tuple**'s
-/// containing an element from each of the underlying generators. As many tuples will be
-/// yielded as the least number of elements yielded from an underlying generator.
-template<Stream S, Stream... Ss>
-Generator<std::tuple<stream_value_t<S>,stream_value_t<Ss>...>&&> zip(std::tuple<S, Ss...> tup) {
+namespace detail {
+
+template<class... Ss>
+Generator<std::tuple<stream_value_t<Ss>...>&&> zip_generator(std::tuple<Ss...> tup) {
     using namespace core;
     using tp::map, tp::map_inplace, tp::all;
     auto iterators = map_inplace([](auto& g) { return g.begin(); }, tup);
@@ -27,6 +28,45 @@ Generator<std::tuple<stream_value_t<S>,stream_value_t<Ss>...>&&> zip(std::tuple<
     co_return;
 }
 
+// Zip contiguous sources with a single index loop rather than
+// advancing an iterator (or resuming a coroutine) per source.
+template<class... Ss>
+Generator<std::tuple<stream_value_t<Ss>...>&&> zip_index_generator(std::tuple<Ss...> tup, size_t count) {
+    auto data = std::apply([](auto&... source) { return std::make_tuple(std::data(source)...); }, tup);
+    for (size_t i = 0; i < count; ++i)
+	co_yield std::apply([i](auto... ptr) { return std::tuple<stream_value_t<Ss>...>{ptr[i]...}; }, data);
+    co_return;
+}
+
+// Zip the tuple of Streams `tup` whose elements are sources or
+// references to sources.
+template<class... Ss>
+Generator<std::tuple<stream_value_t<Ss>...>&&> zip_tuple(std::tuple<Ss...> tup) {
+    if constexpr ((ContiguousStream<Ss> and ...)) {
+	auto count = std::apply([](const auto&... source) { return std::min({stream_size(source)...}); }, tup);
+	auto g = zip_index_generator(std::move(tup), count);
+	g.size_hint({ count, true });
+	return g;
+    } else {
+	return zip_generator(std::move(tup));
+    }
+}
+
+}; // detail
+
+/// Zip the elements from the given tuple of generators.
+///
+/// *Returns:* **Generator<std::tuple<...>>** A generator that yields **std::tuple**'s
+/// containing an element from each of the underlying generators. As many tuples will be
+/// yielded as the least number of elements yielded from an underlying generator.
+///
+/// If every source is a **ContiguousStream** (e.g. **std::vector**), the tuples are
+/// built by a single index loop over the sources.
+template<Stream S, Stream... Ss>
+Generator<std::tuple<stream_value_t<S>,stream_value_t<Ss>...>&&> zip(std::tuple<S, Ss...> tup) {
+    return detail::zip_tuple(std::move(tup));
+}
+
 /// Zip the elements from the preceeding tuple of generators.
 ///
 /// *Returns:* **Generator<std::tuple<...>>** A generator that yields **std::tuple**'s
@@ -52,7 +92,116 @@ inline auto zip() {
 /// tuples will be yieled as the size of the smallest container.
 template<class C, class... Cs>
 auto zip(const C& c, const Cs&... cs) {
-    return zip(std::make_tuple(::coro::adapt(c), ::coro::adapt(cs)...));
+    if constexpr (ContiguousStream<const C&> and (ContiguousStream<const Cs&> and ...))
+	return detail::zip_tuple(std::tuple<const C&, const Cs&...>{c, cs...});
+    else
+	return zip(std::make_tuple(::coro::adapt(c), ::coro::adapt(cs)...));
+}
+
+namespace detail {
+
+// Whether `zip_columns` of the Streams `Ss` can yield spans of the
+// sources themselves rather than of buffers.
+template<class... Ss>
+constexpr bool columns_in_place_v = (ContiguousStream<Ss> and ...);
+
+template<bool InPlace, class S>
+using column_span_t = std::span<std::conditional_t<InPlace,
+						   std::remove_reference_t<stream_yield_t<S>>,
+						   stream_value_t<S>>>;
+
+template<class... Ss>
+using columns_t = std::tuple<column_span_t<columns_in_place_v<Ss...>, Ss>...>;
+
+template<class... Ss>
+Generator<columns_t<Ss...>> zip_columns_generator(std::tuple<Ss...> tup, size_t batch) {
+    if constexpr (columns_in_place_v<Ss...>) {
+	auto count = std::apply([](const auto&... source) { return std::min({stream_size(source)...}); }, tup);
+	auto data = std::apply([](auto&... source) { return std::make_tuple(std::data(source)...); }, tup);
+	for (size_t i = 0; i < count; i += batch) {
+	    auto n = std::min(batch, count - i);
+	    co_yield std::apply([=](auto... ptr) { return columns_t<Ss...>{{ptr + i, n}...}; }, data);
+	}
+    } else {
+	using namespace core;
+	using tp::map, tp::map_inplace, tp::all;
+	auto iterators = map_inplace([](auto& g) { return g.begin(); }, tup);
+	auto end_iters = map_inplace([](auto& g) { return g.end(); }, tup);
+	auto buffers = std::tuple<std::vector<stream_value_t<Ss>>...>{};
+	auto columns = [&](auto func) {
+	    [&]<size_t... Is>(std::index_sequence<Is...>) {
+		(func(std::get<Is>(buffers), std::get<Is>(iterators)), ...);
+	    }(std::index_sequence_for<Ss...>{});
+	};
+	auto more = [&]() {
+	    return all(map([](auto& iter, auto& end) { return iter != end; }, iterators, end_iters));
+	};
+
+	columns([=](auto& buffer, auto&) { buffer.reserve(batch); });
+	while (more()) {
+	    columns([](auto& buffer, auto&) { buffer.clear(); });
+	    for (size_t rows = 0; rows < batch and more(); ++rows)
+		columns([](auto& buffer, auto& iter) {
+		    buffer.push_back(*iter);
+		    ++iter;
+		});
+	    co_yield std::apply([](auto&... buffer) { return columns_t<Ss...>{buffer...}; }, buffers);
+	}
+    }
+    co_return;
+}
+
+}; // detail
+
+/// Zip the given tuple of Streams column-wise, yielding the rows in
+/// batches of at most `batch` as a tuple of **std::span**'s, one per
+/// column (structure of arrays).
+///
+/// A kernel over the spans can be vectorized across the columns with
+/// no tuple built per row. If every source is a **ContiguousStream**
+/// the spans view the sources themselves; otherwise the rows are
+/// buffered and each span is only valid until the generator is
+/// resumed. As many rows are yielded as the shortest source has.
+///
+/// \tparam S An input source that satisfies the **Stream** concept.
+/// \tparam Ss Input source(s) that satisfy the **Stream** concept.
+template<Stream S, Stream... Ss>
+Generator<detail::columns_t<S, Ss...>> zip_columns(std::tuple<S, Ss...> tup, size_t batch) {
+    if (batch == 0)
+	throw std::runtime_error("zip_columns: expected a batch size > 0");
+    SizeHint hint;
+    if constexpr (detail::columns_in_place_v<S, Ss...>) {
+	auto count = std::apply([](const auto&... source) { return std::min({stream_size(source)...}); }, tup);
+	hint = { (count + batch - 1) / batch, true };
+    }
+    auto g = detail::zip_columns_generator(std::move(tup), batch);
+    g.size_hint(hint);
+    return g;
+}
+
+/// Zip the preceeding tuple of Streams column-wise in batches of at
+/// most `batch` rows.
+///
+/// \rst
+/// ```{code-block} cpp
+/// double total{0};
+/// prices * quantities | zip_columns(1024) | apply([&](auto columns) {
+///     auto [price, quantity] = columns;
+///     for (size_t i = 0; i < price.size(); ++i)
+///         total += price[i] * quantity[i];
+/// });
+/// ```
+/// \endrst
+inline auto zip_columns(size_t batch = 1024) {
+    return [=]<class T>(T&& tuple) {
+	return zip_columns(std::move(tuple), batch);
+    };
+}
+
+/// Zip the given containers column-wise in batches of at most `batch` rows.
+template<class C, class... Cs>
+auto zip_columns(size_t batch, const C& c, const Cs&... cs) {
+    return zip_columns(std::tuple<const C&, const Cs&...>{c, cs...}, batch);
 }
 
 }; // coro
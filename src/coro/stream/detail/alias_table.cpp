@@ -0,0 +1,58 @@
+// Copyright (C) 2024 by Mark Melton
+//
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include "coro/stream/detail/alias_table.h"
+
+namespace coro::detail {
+
+AliasTable::AliasTable(std::span<const double> weights) {
+    double total{0};
+    for (auto w : weights) {
+	if (not (w >= 0) or std::isinf(w))
+	    throw std::runtime_error("alias table: weights must be finite and non-negative");
+	total += w;
+    }
+    if (not (total > 0))
+	throw std::runtime_error("alias table: weights must have a positive sum");
+
+    // Scale the weights to average one and pair each slot that is
+    // under-full with an over-full one that donates the remainder.
+    auto n = weights.size();
+    std::vector<double> scaled(n);
+    std::vector<uint32_t> small, large;
+    for (size_t i = 0; i < n; ++i) {
+	scaled[i] = weights[i] * n / total;
+	(scaled[i] < 1 ? small : large).push_back(i);
+    }
+
+    constexpr double Scale = 4294967296.0;
+    slots_.resize(n);
+    while (not small.empty() and not large.empty()) {
+	auto s = small.back();
+	small.pop_back();
+	auto l = large.back();
+	slots_[s] = { uint64_t(scaled[s] * Scale), l };
+	scaled[l] -= 1 - scaled[s];
+	if (scaled[l] < 1) {
+	    large.pop_back();
+	    small.push_back(l);
+	}
+    }
+
+    // What remains is full up to rounding error, except that an index
+    // of zero weight must still never be sampled.
+    auto heaviest = std::max_element(weights.begin(), weights.end()) - weights.begin();
+    for (auto i : large)
+	slots_[i] = { uint64_t(Scale), i };
+    for (auto i : small) {
+	if (weights[i] > 0)
+	    slots_[i] = { uint64_t(Scale), i };
+	else
+	    slots_[i] = { 0, uint32_t(heaviest) };
+    }
+}
+
+}; // coro::detail
@@ -0,0 +1,44 @@
+// Copyright (C) 2024 by Mark Melton
+//
+
+#include <algorithm>
+#include <cmath>
+#include <numbers>
+#include "coro/stream/detail/bloom.h"
+#include "coro/stream/engine.h"
+
+namespace coro::detail {
+
+BloomFilter::BloomFilter(size_t expected, double false_positive, size_t memory_bytes) {
+    expected = std::max<size_t>(expected, 1);
+    false_positive = std::clamp(false_positive, 1e-12, 0.5);
+
+    double bits = memory_bytes > 0
+	? 8.0 * memory_bytes
+	: -double(expected) * std::log(false_positive) / (std::numbers::ln2 * std::numbers::ln2);
+    auto nblocks = std::max<size_t>(std::ceil(bits / 512), 1);
+    blocks_.resize(nblocks, Block{});
+
+    auto bits_per_key = 512.0 * nblocks / expected;
+    probes_ = std::clamp<size_t>(std::lround(bits_per_key * std::numbers::ln2), 1, 16);
+}
+
+bool BloomFilter::insert(uint64_t hash) {
+    // The high bits select the block and successive 9-bit fields of a
+    // remixed hash select the bits within it.
+    auto& block = blocks_[(__uint128_t{hash} * blocks_.size()) >> 64];
+    auto bits = mix64(hash ^ 0x9e3779b97f4a7c15ull);
+    bool present{true};
+    for (size_t i = 0; i < probes_; ++i) {
+	if (i > 0 and i % 7 == 0)
+	    bits = mix64(bits);
+	auto bit = (bits >> (9 * (i % 7))) & 511;
+	auto& word = block.words[bit / 64];
+	auto mask = uint64_t{1} << (bit % 64);
+	present = present and (word & mask);
+	word |= mask;
+    }
+    return not present;
+}
+
+}; // coro::detail
@@ -0,0 +1,164 @@
+// Copyright (C) 2024 by Mark Melton
+//
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <utility>
+#include "coro/stream/detail/bulk_random.h"
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define CORO_STREAM_BULK_X86 1
+#include <immintrin.h>
+#else
+#define CORO_STREAM_BULK_X86 0
+#endif
+
+namespace coro::detail {
+
+namespace {
+
+constexpr size_t Lanes = BulkState::Lanes;
+
+// The calling thread's own bulk engine and the state `random_words`
+// currently draws from if not that one.
+thread_local BulkState tl_bulk;
+thread_local BulkState *tl_bulk_current{nullptr};
+
+BulkState& current_state() {
+    return tl_bulk_current ? *tl_bulk_current : tl_bulk;
+}
+
+// Advance every lane once writing its output to out[lane].
+void step_scalar(BulkState& st, uint64_t *out) {
+    for (size_t i = 0; i < Lanes; ++i) {
+	auto s1 = st.s[1][i];
+	out[i] = std::rotl(s1 * 5, 7) * 9;
+	auto t = s1 << 17;
+	st.s[2][i] ^= st.s[0][i];
+	st.s[3][i] ^= s1;
+	st.s[1][i] ^= st.s[2][i];
+	st.s[0][i] ^= st.s[3][i];
+	st.s[2][i] ^= t;
+	st.s[3][i] = std::rotl(st.s[3][i], 45);
+    }
+}
+
+void generate_scalar(BulkState& st, uint64_t *out, size_t steps) {
+    for (size_t k = 0; k < steps; ++k, out += Lanes)
+	step_scalar(st, out);
+}
+
+#if CORO_STREAM_BULK_X86
+
+__attribute__((target("avx2")))
+inline __m256i rotl_avx2(__m256i x, int k) {
+    return _mm256_or_si256(_mm256_slli_epi64(x, k), _mm256_srli_epi64(x, 64 - k));
+}
+
+// Two groups of four lanes; the multiplies by 5 and 9 are shift-adds
+// since AVX2 has no 64-bit multiply.
+__attribute__((target("avx2")))
+void generate_avx2(BulkState& st, uint64_t *out, size_t steps) {
+    for (size_t g = 0; g < Lanes; g += 4) {
+	auto s0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&st.s[0][g]));
+	auto s1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&st.s[1][g]));
+	auto s2 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&st.s[2][g]));
+	auto s3 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&st.s[3][g]));
+	for (size_t k = 0; k < steps; ++k) {
+	    auto x5 = _mm256_add_epi64(_mm256_slli_epi64(s1, 2), s1);
+	    auto r = rotl_avx2(x5, 7);
+	    auto result = _mm256_add_epi64(_mm256_slli_epi64(r, 3), r);
+	    _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + k * Lanes + g), result);
+
+	    auto t = _mm256_slli_epi64(s1, 17);
+	    s2 = _mm256_xor_si256(s2, s0);
+	    s3 = _mm256_xor_si256(s3, s1);
+	    s1 = _mm256_xor_si256(s1, s2);
+	    s0 = _mm256_xor_si256(s0, s3);
+	    s2 = _mm256_xor_si256(s2, t);
+	    s3 = rotl_avx2(s3, 45);
+	}
+	_mm256_storeu_si256(reinterpret_cast<__m256i*>(&st.s[0][g]), s0);
+	_mm256_storeu_si256(reinterpret_cast<__m256i*>(&st.s[1][g]), s1);
+	_mm256_storeu_si256(reinterpret_cast<__m256i*>(&st.s[2][g]), s2);
+	_mm256_storeu_si256(reinterpret_cast<__m256i*>(&st.s[3][g]), s3);
+    }
+}
+
+// All eight lanes in one register with native rotates and multiplies.
+__attribute__((target("avx512f,avx512dq")))
+void generate_avx512(BulkState& st, uint64_t *out, size_t steps) {
+    auto s0 = _mm512_loadu_si512(&st.s[0][0]);
+    auto s1 = _mm512_loadu_si512(&st.s[1][0]);
+    auto s2 = _mm512_loadu_si512(&st.s[2][0]);
+    auto s3 = _mm512_loadu_si512(&st.s[3][0]);
+    auto five = _mm512_set1_epi64(5);
+    auto nine = _mm512_set1_epi64(9);
+    for (size_t k = 0; k < steps; ++k) {
+	auto result = _mm512_mullo_epi64(_mm512_rol_epi64(_mm512_mullo_epi64(s1, five), 7), nine);
+	_mm512_storeu_si512(out + k * Lanes, result);
+
+	auto t = _mm512_slli_epi64(s1, 17);
+	s2 = _mm512_xor_si512(s2, s0);
+	s3 = _mm512_xor_si512(s3, s1);
+	s1 = _mm512_xor_si512(s1, s2);
+	s0 = _mm512_xor_si512(s0, s3);
+	s2 = _mm512_xor_si512(s2, t);
+	s3 = _mm512_rol_epi64(s3, 45);
+    }
+    _mm512_storeu_si512(&st.s[0][0], s0);
+    _mm512_storeu_si512(&st.s[1][0], s1);
+    _mm512_storeu_si512(&st.s[2][0], s2);
+    _mm512_storeu_si512(&st.s[3][0], s3);
+}
+
+#endif
+
+using Generate = void (*)(BulkState&, uint64_t*, size_t);
+
+Generate select_generate() {
+#if CORO_STREAM_BULK_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f") and __builtin_cpu_supports("avx512dq"))
+	return generate_avx512;
+    if (__builtin_cpu_supports("avx2"))
+	return generate_avx2;
+#endif
+    return generate_scalar;
+}
+
+}; // anonymous
+
+BulkState *exchange_bulk_state(BulkState *state) {
+    return std::exchange(tl_bulk_current, state);
+}
+
+void reseed_random_words() {
+    auto seed = rng()();
+    auto& st = current_state();
+    for (size_t lane = 0; lane < Lanes; ++lane) {
+	SplitMix64 init{seed, lane + 1};
+	for (size_t w = 0; w < 4; ++w)
+	    st.s[w][lane] = init();
+    }
+    st.seeded = true;
+}
+
+void random_words(std::span<uint64_t> words) {
+    static const Generate generate = select_generate();
+    auto& st = current_state();
+    if (not st.seeded)
+	reseed_random_words();
+
+    auto steps = words.size() / Lanes;
+    generate(st, words.data(), steps);
+
+    if (auto rem = words.size() % Lanes) {
+	uint64_t tail[Lanes];
+	step_scalar(st, tail);
+	std::memcpy(words.data() + steps * Lanes, tail, rem * sizeof(uint64_t));
+    }
+}
+
+}; // coro::detail
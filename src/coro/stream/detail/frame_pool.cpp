@@ -0,0 +1,92 @@
+// Copyright (C) 2024 by Mark Melton
+//
+
+#include <array>
+#include "coro/stream/detail/frame_pool.h"
+
+namespace coro::detail {
+
+namespace {
+
+// Frames are pooled in size classes of `Granularity` bytes up to
+// `Granularity * NumberClasses` bytes; larger frames go directly to
+// the global allocator. Released frames are cached across all classes
+// up to `MaxCachedBytes` per thread, which is the memory each thread
+// that has run generators (including pipeline and pool workers) may
+// retain until it exits; beyond that frames are freed.
+constexpr std::size_t Granularity = 64;
+constexpr std::size_t NumberClasses = 16;
+constexpr std::size_t MaxCachedBytes = 1 << 20;
+
+class FramePool {
+public:
+    ~FramePool();
+
+    void *allocate(std::size_t size) {
+	auto idx = (size - 1) / Granularity;
+	if (idx >= NumberClasses)
+	    return ::operator new(size);
+
+	auto& head = free_[idx];
+	if (head == nullptr)
+	    return ::operator new((idx + 1) * Granularity);
+
+	auto node = head;
+	head = node->next;
+	cached_bytes_ -= (idx + 1) * Granularity;
+	return node;
+    }
+
+    void deallocate(void *ptr, std::size_t size) noexcept {
+	auto idx = (size - 1) / Granularity;
+	auto bytes = (idx + 1) * Granularity;
+	if (idx >= NumberClasses or cached_bytes_ + bytes > MaxCachedBytes) {
+	    ::operator delete(ptr);
+	    return;
+	}
+
+	auto node = static_cast<Node*>(ptr);
+	node->next = free_[idx];
+	free_[idx] = node;
+	cached_bytes_ += bytes;
+    }
+
+private:
+    struct Node { Node *next; };
+    std::array<Node*, NumberClasses> free_{};
+    std::size_t cached_bytes_{0};
+};
+
+// Frames released during thread (or program) teardown after the
+// pool has been destroyed go directly to the global allocator.
+thread_local bool tl_pool_destroyed{false};
+thread_local FramePool tl_pool;
+
+FramePool::~FramePool() {
+    for (auto node : free_) {
+	while (node) {
+	    auto next = node->next;
+	    ::operator delete(node);
+	    node = next;
+	}
+    }
+    tl_pool_destroyed = true;
+}
+
+}; // anonymous
+
+void *pool_allocate(std::size_t size) {
+    if (not CORO_STREAM_FRAME_POOL or tl_pool_destroyed)
+	return ::operator new(size);
+    return tl_pool.allocate(size);
+}
+
+void pool_deallocate(void *ptr, std::size_t size) noexcept {
+    if (not CORO_STREAM_FRAME_POOL or tl_pool_destroyed) {
+	::operator delete(ptr);
+	return;
+    }
+    tl_pool.deallocate(ptr, size);
+}
+
+}; // coro::detail
@@ -1,12 +1,27 @@
-// Copyright (C) 2017, 2019, 2022 by Mark Melton
+// Copyright (C) 2017, 2019, 2022, 2024 by Mark Melton
 //
 
-#include "coro/stream/detail/random.h"
+#include <atomic>
+#include "coro/stream/detail/bulk_random.h"
 
 namespace coro::detail {
 
-static std::mt19937 gs_rng;
+static std::atomic<uint64_t> gs_seed{EngineBase::DefaultSeed};
+static std::atomic<uint64_t> gs_stream{0};
 
-std::mt19937& rng() { return gs_rng; }
+uint64_t rng_seed() { return gs_seed.load(std::memory_order_relaxed); }
+
+uint64_t next_rng_stream() { return gs_stream.fetch_add(1, std::memory_order_relaxed); }
+
+};
+
+namespace coro {
+
+void seed_rng(uint64_t seed) {
+    detail::gs_seed.store(seed, std::memory_order_relaxed);
+    auto& state = detail::thread_engine_state<Engine>();
+    state.engine.seed(seed, state.stream);
+    detail::reseed_random_words();
+}
 
 };
@@ -0,0 +1,584 @@
+// Copyright 2024 by Mark Melton
+//
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#include "coro/stream/io/uring.h"
+
+#if defined(__linux__) && __has_include(<linux/io_uring.h>)
+#define CORO_STREAM_HAVE_URING 1
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#else
+#define CORO_STREAM_HAVE_URING 0
+#endif
+
+namespace coro::detail {
+
+namespace {
+
+[[noreturn]] void throw_errno(const std::string& what, int error) {
+    throw std::runtime_error(what + ": " + std::strerror(error));
+}
+
+// A completion of a request on buffer `index` with the number of
+// bytes transferred or a negated errno.
+struct Completion {
+    size_t index;
+    ssize_t result;
+};
+
+// Asynchronous positional reads and writes. Each request is tagged
+// with the index of the buffer it uses and at most one request per
+// buffer is outstanding.
+class AsyncIo {
+public:
+    virtual ~AsyncIo() = default;
+    virtual void read(size_t index, int fd, char *buf, size_t len, uint64_t offset) = 0;
+    virtual void write(size_t index, int fd, const char *buf, size_t len, uint64_t offset) = 0;
+    // Wait for and return the next completion.
+    virtual Completion wait() = 0;
+    virtual bool uring() const = 0;
+
+    // Wait for all outstanding requests ignoring their results. This
+    // is called from destructors, so a failure to wait ends the drain
+    // rather than throwing (closing an io_uring cancels what remains).
+    void drain() noexcept {
+	try {
+	    while (outstanding_ > 0)
+		wait();
+	} catch (...) {
+	}
+    }
+
+protected:
+    size_t outstanding_{0};
+};
+
+// Issue the requests from a background thread using pread and pwrite.
+class ThreadIo : public AsyncIo {
+public:
+    ThreadIo() : thread_([this]() { run(); }) { }
+
+    ~ThreadIo() override {
+	{
+	    std::lock_guard lock{mutex_};
+	    stop_ = true;
+	}
+	request_cv_.notify_one();
+	thread_.join();
+    }
+
+    void read(size_t index, int fd, char *buf, size_t len, uint64_t offset) override {
+	push({index, fd, buf, len, offset, false});
+    }
+
+    void write(size_t index, int fd, const char *buf, size_t len, uint64_t offset) override {
+	push({index, fd, const_cast<char*>(buf), len, offset, true});
+    }
+
+    Completion wait() override {
+	std::unique_lock lock{mutex_};
+	completion_cv_.wait(lock, [&]() { return not completions_.empty(); });
+	auto completion = completions_.front();
+	completions_.pop_front();
+	--outstanding_;
+	return completion;
+    }
+
+    bool uring() const override {
+	return false;
+    }
+
+private:
+    struct Request {
+	size_t index;
+	int fd;
+	char *buf;
+	size_t len;
+	uint64_t offset;
+	bool write;
+    };
+
+    void push(const Request& request) {
+	{
+	    std::lock_guard lock{mutex_};
+	    requests_.push_back(request);
+	}
+	++outstanding_;
+	request_cv_.notify_one();
+    }
+
+    static ssize_t transfer(const Request& r) {
+	size_t done{0};
+	while (done < r.len) {
+	    auto n = r.write
+		? ::pwrite(r.fd, r.buf + done, r.len - done, r.offset + done)
+		: ::pread(r.fd, r.buf + done, r.len - done, r.offset + done);
+	    if (n < 0 and errno == EINTR)
+		continue;
+	    if (n < 0)
+		return -errno;
+	    if (n == 0)
+		break;
+	    done += n;
+	}
+	return done;
+    }
+
+    void run() {
+	while (true) {
+	    Request request;
+	    {
+		std::unique_lock lock{mutex_};
+		request_cv_.wait(lock, [&]() { return stop_ or not requests_.empty(); });
+		if (requests_.empty())
+		    return;
+		request = requests_.front();
+		requests_.pop_front();
+	    }
+	    auto result = transfer(request);
+	    {
+		std::lock_guard lock{mutex_};
+		completions_.push_back({request.index, result});
+	    }
+	    completion_cv_.notify_one();
+	}
+    }
+
+    std::mutex mutex_;
+    std::condition_variable request_cv_;
+    std::condition_variable completion_cv_;
+    std::deque<Request> requests_;
+    std::deque<Completion> completions_;
+    bool stop_{false};
+    std::thread thread_;
+};
+
+// A file descriptor, closed on destruction so that a partially
+// constructed owner does not leak it.
+struct FileDescriptor {
+    int fd{-1};
+
+    FileDescriptor() = default;
+    FileDescriptor(const FileDescriptor&) = delete;
+    FileDescriptor& operator=(const FileDescriptor&) = delete;
+
+    ~FileDescriptor() {
+	if (fd >= 0)
+	    ::close(fd);
+    }
+};
+
+#if CORO_STREAM_HAVE_URING
+
+// A shared mapping of part of an io_uring, unmapped on destruction.
+struct RingMapping {
+    void *ptr{nullptr};
+    size_t size{0};
+
+    RingMapping() = default;
+    RingMapping(const RingMapping&) = delete;
+    RingMapping& operator=(const RingMapping&) = delete;
+
+    ~RingMapping() {
+	if (ptr)
+	    ::munmap(ptr, size);
+    }
+
+    // Throws **std::runtime_error** if the mapping fails.
+    void map(int fd, size_t bytes, off_t offset) {
+	auto p = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+			fd, offset);
+	if (p == MAP_FAILED)
+	    throw_errno("io_uring mmap", errno);
+	ptr = p;
+	size = bytes;
+    }
+};
+
+// A minimal io_uring driven directly through the system calls so that
+// liburing is not required.
+class UringIo : public AsyncIo {
+public:
+    // Throws **std::runtime_error** if the kernel does not support
+    // io_uring. The descriptor and mappings are members so that a
+    // partially constructed ring is released.
+    explicit UringIo(size_t depth) : iovecs_(depth) {
+	io_uring_params params;
+	std::memset(&params, 0, sizeof(params));
+	ring_.fd = ::syscall(__NR_io_uring_setup, unsigned(depth), &params);
+	if (ring_.fd < 0)
+	    throw_errno("io_uring_setup", errno);
+
+	auto sq_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+	auto cq_size = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+	bool single_mmap = params.features & IORING_FEAT_SINGLE_MMAP;
+	if (single_mmap)
+	    sq_size = cq_size = std::max(sq_size, cq_size);
+
+	sq_map_.map(ring_.fd, sq_size, IORING_OFF_SQ_RING);
+	if (not single_mmap)
+	    cq_map_.map(ring_.fd, cq_size, IORING_OFF_CQ_RING);
+	sqes_map_.map(ring_.fd, params.sq_entries * sizeof(io_uring_sqe), IORING_OFF_SQES);
+	sqes_ = static_cast<io_uring_sqe*>(sqes_map_.ptr);
+
+	auto sq = static_cast<char*>(sq_map_.ptr);
+	sq_tail_ = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+	sq_mask_ = *reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+	sq_array_ = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+
+	auto cq = static_cast<char*>(single_mmap ? sq_map_.ptr : cq_map_.ptr);
+	cq_head_ = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+	cq_tail_ = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+	cq_mask_ = *reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+	cqes_ = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+    }
+
+    ~UringIo() override {
+	drain();
+    }
+
+    void read(size_t index, int fd, char *buf, size_t len, uint64_t offset) override {
+	submit(IORING_OP_READV, index, fd, buf, len, offset);
+    }
+
+    void write(size_t index, int fd, const char *buf, size_t len, uint64_t offset) override {
+	submit(IORING_OP_WRITEV, index, fd, const_cast<char*>(buf), len, offset);
+    }
+
+    Completion wait() override {
+	while (true) {
+	    auto head = *cq_head_;
+	    auto tail = __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE);
+	    if (head != tail) {
+		auto& cqe = cqes_[head & cq_mask_];
+		Completion completion{size_t(cqe.user_data), cqe.res};
+		__atomic_store_n(cq_head_, head + 1, __ATOMIC_RELEASE);
+		--outstanding_;
+		return completion;
+	    }
+	    if (enter(0, 1, IORING_ENTER_GETEVENTS) < 0 and errno != EINTR)
+		throw_errno("io_uring_enter", errno);
+	}
+    }
+
+    bool uring() const override {
+	return true;
+    }
+
+private:
+    int enter(unsigned to_submit, unsigned min_complete, unsigned flags) {
+	return ::syscall(__NR_io_uring_enter, ring_.fd, to_submit, min_complete, flags, nullptr, 0);
+    }
+
+    void submit(uint8_t opcode, size_t index, int fd, char *buf, size_t len, uint64_t offset) {
+	iovecs_[index] = {buf, len};
+	auto tail = *sq_tail_;
+	auto slot = tail & sq_mask_;
+	auto& sqe = sqes_[slot];
+	std::memset(&sqe, 0, sizeof(sqe));
+	sqe.opcode = opcode;
+	sqe.fd = fd;
+	sqe.addr = reinterpret_cast<uint64_t>(&iovecs_[index]);
+	sqe.len = 1;
+	sqe.off = offset;
+	sqe.user_data = index;
+	sq_array_[slot] = slot;
+	__atomic_store_n(sq_tail_, tail + 1, __ATOMIC_RELEASE);
+
+	while (enter(1, 0, 0) < 0) {
+	    if (errno != EINTR and errno != EAGAIN)
+		throw_errno("io_uring_enter", errno);
+	}
+	++outstanding_;
+    }
+
+    // Destroyed in reverse order: the mappings before the descriptor.
+    FileDescriptor ring_;
+    RingMapping sq_map_, cq_map_, sqes_map_;
+    io_uring_sqe *sqes_{nullptr};
+    unsigned *sq_tail_, *sq_array_, sq_mask_;
+    unsigned *cq_head_, *cq_tail_, cq_mask_;
+    io_uring_cqe *cqes_;
+    std::vector<iovec> iovecs_;
+};
+
+#endif
+
+std::unique_ptr<AsyncIo> make_async_io(const AsyncOptions& options) {
+#if CORO_STREAM_HAVE_URING
+    if (options.uring) {
+	try {
+	    return std::make_unique<UringIo>(options.depth);
+	} catch (const std::runtime_error&) {
+	    // Fall through to the thread implementation.
+	}
+    }
+#endif
+    return std::make_unique<ThreadIo>();
+}
+
+// Complete a short transfer synchronously.
+void complete_transfer(bool write, int fd, char *buf, size_t len, uint64_t offset, size_t done) {
+    while (done < len) {
+	auto n = write
+	    ? ::pwrite(fd, buf + done, len - done, offset + done)
+	    : ::pread(fd, buf + done, len - done, offset + done);
+	if (n < 0 and errno == EINTR)
+	    continue;
+	if (n < 0)
+	    throw_errno(write ? "write_lines_uring" : "read_lines_uring", errno);
+	if (n == 0)
+	    throw std::runtime_error("read_lines_uring: unexpected end of file");
+	done += n;
+    }
+}
+
+AsyncOptions sanitize(AsyncOptions options) {
+    options.block_bytes = std::max<size_t>(options.block_bytes, 1);
+    options.depth = std::max<size_t>(options.depth, 1);
+    return options;
+}
+
+}; // anonymous
+
+struct BlockReader::Impl {
+    Impl(std::string_view file, const AsyncOptions& opts)
+	: options(sanitize(opts))
+	, buffers(options.depth, std::vector<char>(options.block_bytes))
+	, done(options.depth, false)
+	, results(options.depth, 0) {
+	std::string name{file};
+	descriptor.fd = ::open(name.c_str(), O_RDONLY);
+	if (descriptor.fd < 0)
+	    throw_errno("read_lines_uring: cannot open " + name, errno);
+
+	struct stat st;
+	if (::fstat(descriptor.fd, &st) < 0)
+	    throw_errno("read_lines_uring: cannot stat " + name, errno);
+	size = st.st_size;
+	blocks = (size + options.block_bytes - 1) / options.block_bytes;
+
+	io = make_async_io(options);
+	for (uint64_t block = 0; block < std::min<uint64_t>(blocks, options.depth); ++block)
+	    submit(block);
+    }
+
+    ~Impl() {
+	io->drain();
+	io.reset();
+    }
+
+    size_t length(uint64_t block) const {
+	return std::min<uint64_t>(options.block_bytes, size - block * options.block_bytes);
+    }
+
+    void submit(uint64_t block) {
+	auto idx = block % options.depth;
+	io->read(idx, descriptor.fd, buffers[idx].data(), length(block), block * options.block_bytes);
+    }
+
+    std::string_view next() {
+	// The buffer returned by the previous call is free again.
+	if (next_block > 0 and next_block - 1 + options.depth < blocks)
+	    submit(next_block - 1 + options.depth);
+
+	if (next_block == blocks)
+	    return {};
+
+	auto idx = next_block % options.depth;
+	while (not done[idx]) {
+	    auto completion = io->wait();
+	    if (completion.result < 0)
+		throw_errno("read_lines_uring", -completion.result);
+	    done[completion.index] = true;
+	    results[completion.index] = completion.result;
+	}
+
+	auto len = length(next_block);
+	auto offset = next_block * options.block_bytes;
+	complete_transfer(false, descriptor.fd, buffers[idx].data(), len, offset, results[idx]);
+	done[idx] = false;
+	++next_block;
+	return {buffers[idx].data(), len};
+    }
+
+    AsyncOptions options;
+    FileDescriptor descriptor;
+    uint64_t size{0};
+    uint64_t blocks{0};
+    uint64_t next_block{0};
+    std::vector<std::vector<char>> buffers;
+    std::vector<bool> done;
+    std::vector<ssize_t> results;
+    std::unique_ptr<AsyncIo> io;
+};
+
+BlockReader::BlockReader(std::string_view file, const AsyncOptions& options)
+    : impl_(std::make_unique<Impl>(file, options)) {
+}
+
+BlockReader::~BlockReader() = default;
+
+std::string_view BlockReader::next() {
+    return impl_->next();
+}
+
+bool BlockReader::uring() const {
+    return impl_->io->uring();
+}
+
+struct BlockWriter::Impl {
+    Impl(std::string_view file, const AsyncOptions& opts)
+	: options(sanitize(opts))
+	, buffers(options.depth, std::vector<char>(options.block_bytes))
+	, lengths(options.depth, 0)
+	, offsets(options.depth, 0)
+	, in_flight(options.depth, false)
+	, start(std::chrono::steady_clock::now()) {
+	std::string name{file};
+	descriptor.fd = ::open(name.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+	if (descriptor.fd < 0)
+	    throw_errno("write_lines_uring: cannot open " + name, errno);
+	io = make_async_io(options);
+    }
+
+    ~Impl() {
+	io->drain();
+	io.reset();
+    }
+
+    void write(std::string_view data) {
+	while (not data.empty()) {
+	    auto n = std::min(data.size(), options.block_bytes - used);
+	    std::memcpy(buffers[current].data() + used, data.data(), n);
+	    used += n;
+	    data.remove_prefix(n);
+	    if (used == options.block_bytes)
+		submit();
+	}
+    }
+
+    void submit() {
+	lengths[current] = used;
+	offsets[current] = offset;
+	in_flight[current] = true;
+	io->write(current, descriptor.fd, buffers[current].data(), used, offset);
+	offset += used;
+	stats.bytes += used;
+	++stats.flushes;
+	used = 0;
+	current = (current + 1) % options.depth;
+	while (in_flight[current])
+	    complete(io->wait());
+    }
+
+    void complete(const Completion& completion) {
+	auto idx = completion.index;
+	if (completion.result < 0)
+	    throw_errno("write_lines_uring", -completion.result);
+	in_flight[idx] = false;
+	complete_transfer(true, descriptor.fd, buffers[idx].data(), lengths[idx], offsets[idx],
+			  completion.result);
+    }
+
+    WriteStats finish() {
+	if (used > 0)
+	    submit();
+	for (size_t idx = 0; idx < options.depth; ++idx)
+	    while (in_flight[idx])
+		complete(io->wait());
+	stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now()
+						      - start).count();
+	return stats;
+    }
+
+    AsyncOptions options;
+    FileDescriptor descriptor;
+    std::vector<std::vector<char>> buffers;
+    std::vector<size_t> lengths;
+    std::vector<uint64_t> offsets;
+    std::vector<bool> in_flight;
+    size_t current{0};
+    size_t used{0};
+    uint64_t offset{0};
+    WriteStats stats;
+    std::chrono::steady_clock::time_point start;
+    std::unique_ptr<AsyncIo> io;
+};
+
+BlockWriter::BlockWriter(std::string_view file, const AsyncOptions& options)
+    : impl_(std::make_unique<Impl>(file, options)) {
+}
+
+BlockWriter::~BlockWriter() = default;
+
+void BlockWriter::write_line(std::string_view line) {
+    impl_->write(line);
+    impl_->write("\n");
+    ++impl_->stats.lines;
+}
+
+WriteStats BlockWriter::finish() {
+    return impl_->finish();
+}
+
+bool BlockWriter::uring() const {
+    return impl_->io->uring();
+}
+
+}; // coro::detail
+
+namespace coro {
+
+namespace {
+
+Generator<std::string_view> read_lines_blocks(std::unique_ptr<detail::BlockReader> reader) {
+    // A line spanning blocks is assembled in `partial`.
+    std::string partial;
+    for (auto block = reader->next(); not block.empty(); block = reader->next()) {
+	while (not block.empty()) {
+	    auto eol = block.find('\n');
+	    if (eol == std::string_view::npos) {
+		partial.append(block);
+		break;
+	    }
+	    if (partial.empty()) {
+		co_yield block.substr(0, eol);
+	    } else {
+		partial.append(block.substr(0, eol));
+		co_yield std::string_view{partial};
+		partial.clear();
+	    }
+	    block.remove_prefix(eol + 1);
+	}
+    }
+    if (not partial.empty())
+	co_yield std::string_view{partial};
+    co_return;
+}
+
+}; // anonymous
+
+Generator<std::string_view> read_lines_uring(std::string_view file, AsyncOptions options) {
+    // Open the file and issue the first reads eagerly so that errors
+    // are reported immediately and `file` need not outlive the call.
+    return read_lines_blocks(std::make_unique<detail::BlockReader>(file, options));
+}
+
+}; // coro
@@ -0,0 +1,104 @@
+// Copyright 2024 by Mark Melton
+//
+
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <fcntl.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#include "coro/stream/io/write_lines.h"
+
+namespace coro::detail {
+
+namespace {
+
+// Write all of `iov` handling partial writes and interruptions.
+size_t writev_all(int fd, iovec *iov, int count) {
+    size_t total{0};
+    while (count > 0) {
+	auto n = ::writev(fd, iov, count);
+	if (n < 0) {
+	    if (errno == EINTR)
+		continue;
+	    throw std::runtime_error(std::string{"write_lines: write failed: "}
+				     + std::strerror(errno));
+	}
+	total += n;
+	while (count > 0 and size_t(n) >= iov->iov_len) {
+	    n -= iov->iov_len;
+	    ++iov;
+	    --count;
+	}
+	if (count > 0) {
+	    iov->iov_base = static_cast<char*>(iov->iov_base) + n;
+	    iov->iov_len -= n;
+	}
+    }
+    return total;
+}
+
+}; // anonymous
+
+FdWriter::FdWriter(int fd, const WriteOptions& options)
+    : fd_(fd)
+    , owned_(false)
+    , options_(options)
+    , buffer_(std::max<size_t>(options.buffer_bytes, 1))
+    , start_(std::chrono::steady_clock::now()) {
+}
+
+FdWriter::FdWriter(std::string_view file, const WriteOptions& options)
+    : FdWriter(-1, options) {
+    std::string name{file};
+    fd_ = ::open(name.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd_ < 0)
+	throw std::runtime_error("write_lines_file: cannot open " + name);
+    owned_ = true;
+}
+
+FdWriter::~FdWriter() {
+    if (owned_)
+	::close(fd_);
+}
+
+void FdWriter::write(std::string_view line) {
+    if (used_ + line.size() + 1 <= buffer_.size()) {
+	std::memcpy(buffer_.data() + used_, line.data(), line.size());
+	used_ += line.size();
+	buffer_[used_++] = '\n';
+    } else {
+	flush(line, true);
+    }
+
+    ++stats_.lines;
+    if (options_.flush_lines > 0 and ++pending_lines_ >= options_.flush_lines)
+	flush();
+}
+
+WriteStats FdWriter::finish() {
+    flush();
+    stats_.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_).count();
+    return stats_;
+}
+
+void FdWriter::flush(std::string_view line, bool newline) {
+    iovec iov[3];
+    int count{0};
+    if (used_ > 0)
+	iov[count++] = {buffer_.data(), used_};
+    if (not line.empty())
+	iov[count++] = {const_cast<char*>(line.data()), line.size()};
+    if (newline)
+	iov[count++] = {const_cast<char*>("\n"), 1};
+    if (count == 0)
+	return;
+
+    stats_.bytes += writev_all(fd_, iov, count);
+    ++stats_.flushes;
+    used_ = 0;
+    pending_lines_ = 0;
+}
+
+}; // coro::detail
@@ -0,0 +1,150 @@
+// Copyright (C) 2024 by Mark Melton
+//
+
+#include <cctype>
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include "coro/stream/sampler/distribution.h"
+
+namespace coro {
+
+namespace detail {
+
+const NormalZiggurat& normal_ziggurat() {
+    static const NormalZiggurat zig = []() {
+	// `V` is the area of each layer and of the base strip with its
+	// tail, for which the layers exactly cover the density.
+	constexpr double V = 0.00492867323399;
+	auto pdf = [](double x) { return std::exp(-x * x / 2); };
+	NormalZiggurat z;
+	z.x[0] = V / pdf(z.R);
+	z.x[1] = z.R;
+	for (size_t i = 2; i < 256; ++i)
+	    z.x[i] = std::sqrt(std::max(0.0, -2 * std::log(V / z.x[i - 1] + pdf(z.x[i - 1]))));
+	z.x[256] = 0;
+	for (size_t i = 0; i < 257; ++i)
+	    z.f[i] = pdf(z.x[i]);
+	return z;
+    }();
+    return zig;
+}
+
+}; // detail
+
+namespace dist {
+
+namespace {
+
+// log1p(x) / x and expm1(x) / x accurate near zero.
+
+double log1p_ratio(double x) {
+    if (std::abs(x) > 1e-8)
+	return std::log1p(x) / x;
+    return 1 - x * (0.5 - x * (1.0 / 3 - 0.25 * x));
+}
+
+double expm1_ratio(double x) {
+    if (std::abs(x) > 1e-8)
+	return std::expm1(x) / x;
+    return 1 + x * 0.5 * (1 + x * (1.0 / 3) * (1 + 0.25 * x));
+}
+
+}; // anonymous
+
+Zipf::Zipf(uint64_t n, double s)
+    : n_(n)
+    , s_(s) {
+    if (n == 0 or not (s > 0))
+	throw std::runtime_error("zipf: expected n > 0 and s > 0");
+    h_integral_x1_ = h_integral(1.5) - 1;
+    h_integral_n_ = h_integral(n + 0.5);
+    threshold_ = 2 - h_integral_inverse(h_integral(2.5) - h(2));
+}
+
+// h(x) = 1/x^s is the density the ranks are sampled from and
+// h_integral is its antiderivative, (x^(1-s) - 1) / (1 - s).
+
+double Zipf::h(double x) const {
+    return std::exp(-s_ * std::log(x));
+}
+
+double Zipf::h_integral(double x) const {
+    auto log_x = std::log(x);
+    return expm1_ratio((1 - s_) * log_x) * log_x;
+}
+
+double Zipf::h_integral_inverse(double x) const {
+    auto t = std::max(x * (1 - s_), -1.0);
+    return std::exp(log1p_ratio(t) * x);
+}
+
+Exponential::Exponential(double lambda)
+    : scale_(1 / lambda) {
+    if (not (lambda > 0) or std::isinf(lambda))
+	throw std::runtime_error("exponential: expected a finite lambda > 0");
+}
+
+Poisson::Poisson(double mean)
+    : mean_(mean) {
+    if (not (mean > 0) or std::isinf(mean))
+	throw std::runtime_error("poisson: expected a finite mean > 0");
+    exp_mean_ = std::exp(-mean);
+    log_mean_ = std::log(mean);
+    auto smu = std::sqrt(mean);
+    b_ = 0.931 + 2.53 * smu;
+    a_ = -0.059 + 0.02483 * b_;
+    log_inv_alpha_ = std::log(1.1239 + 1.1328 / (b_ - 3.4));
+    vr_ = 0.9277 - 3.6224 / (b_ - 2);
+}
+
+Empirical::Empirical(std::vector<double> values, std::vector<double> weights)
+    : values_(std::move(values)) {
+    if (values_.size() != weights.size() or values_.empty())
+	throw std::runtime_error("empirical: expected one weight per value");
+    table_ = detail::AliasTable{weights};
+}
+
+Empirical Empirical::load(std::string_view file) {
+    std::ifstream ifs{std::string{file}};
+    if (not ifs)
+	throw std::runtime_error("empirical: cannot open " + std::string{file});
+
+    std::vector<double> values, weights;
+    std::string line;
+    for (size_t number = 1; std::getline(ifs, line); ++number) {
+	// strtod rather than from_chars which not every standard
+	// library supports for floating point.
+	const char *ptr = line.c_str();
+	char *end;
+	while (std::isspace(*ptr))
+	    ++ptr;
+	if (*ptr == '\0' or *ptr == '#')
+	    continue;
+
+	auto value = std::strtod(ptr, &end);
+	if (end == ptr)
+	    throw std::runtime_error("empirical: bad value on line " + std::to_string(number));
+	ptr = end;
+	while (std::isspace(*ptr))
+	    ++ptr;
+
+	double weight{1};
+	if (*ptr != '\0') {
+	    weight = std::strtod(ptr, &end);
+	    bool parsed = end != ptr;
+	    for (ptr = end; std::isspace(*ptr); ++ptr);
+	    if (not parsed or *ptr != '\0')
+		throw std::runtime_error("empirical: bad weight on line " + std::to_string(number));
+	}
+	values.push_back(value);
+	weights.push_back(weight);
+    }
+    return Empirical{std::move(values), std::move(weights)};
+}
+
+}; // dist
+
+}; // coro
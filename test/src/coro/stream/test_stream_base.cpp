@@ -2,7 +2,10 @@
 //
 
 #include <gtest/gtest.h>
+#include <numeric>
 #include <deque>
+#include <chrono>
+#include <thread>
 #include "coro/stream/stream.h"
 #include "core/mp/foreach.h"
 #include "coro/stream/detail/fixed.h"
@@ -51,6 +54,18 @@ TEST(CoroStream, AlternateFixedVector)
     EXPECT_EQ(count, 31);
 }
 
+TEST(CoroStream, AlternateVector)
+{
+    std::vector<Generator<const int&>> sources;
+    for (auto i = 0; i < 100; ++i)
+	sources.push_back(iota<int>(i % 7, i, 100));
+    auto c = std::move(sources) | alternate() | collect<std::vector>();
+    EXPECT_EQ(c.size(), 14 * 21 + 1);
+    EXPECT_TRUE(std::is_sorted(c.begin(), c.end()));
+    for (auto n : c)
+	EXPECT_LT(n / 100, n % 100 % 7);
+}
+
 TEST(CoroStream, Apply)
 {
     auto count{0};
@@ -99,6 +114,87 @@ TEST(CoroStream, ChooseFixedVector)
     EXPECT_EQ(count, 28);
 }
 
+TEST(CoroStream, Chunked)
+{
+    std::vector<size_t> sizes;
+    std::vector<int> elems;
+    for (auto chunk : iota<int>(10) | chunked(4)) {
+	sizes.push_back(chunk.size());
+	elems.insert(elems.end(), chunk.begin(), chunk.end());
+    }
+    EXPECT_EQ(sizes, (std::vector<size_t>{4, 4, 2}));
+    EXPECT_EQ(elems, iota<int>(10) | collect<std::vector>());
+
+    std::array<int, 3> buffer;
+    auto actual = iota<int>(10) | chunked(std::span<int>{buffer}) | unchunked() | collect<std::vector>();
+    EXPECT_EQ(actual, elems);
+
+    EXPECT_THROW(iota<int>(10) | chunked(0), std::runtime_error);
+    EXPECT_THROW(iota<int>(10) | chunked(std::span<int>{}), std::runtime_error);
+    EXPECT_THROW(chunk::iota<int>(10, 0, 1, 0), std::runtime_error);
+}
+
+TEST(CoroStream, ChunkOperations)
+{
+    auto expected = iota<int64_t>(1000)
+	| filter([](int64_t n) { return n % 3 == 0; })
+	| transform([](int64_t n) { return n * n; })
+	| collect<std::vector>();
+    auto actual = chunk::iota<int64_t>(1000, 0, 1, 64)
+	| chunk::filter([](int64_t n) { return n % 3 == 0; })
+	| chunk::transform([](int64_t n) { return n * n; })
+	| chunk::collect<std::vector>();
+    EXPECT_EQ(actual, expected);
+
+    auto sum = chunk::iota<int64_t>(1000, 0, 1, 64)
+	| chunk::reduce(int64_t{0}, [](int64_t& acc, int64_t n) { acc += n; });
+    EXPECT_EQ(sum, 999 * 1000 / 2);
+}
+
+TEST(CoroStream, ChooseVector)
+{
+    std::vector<Generator<const int&>> sources;
+    for (auto i = 0; i < 100; ++i)
+	sources.push_back(iota<int>(i % 7, 100 * i));
+    auto g = std::move(sources) | choose();
+    std::vector<int> last(100, -1);
+    size_t count{0};
+    for (auto elem : g) {
+	auto& prev = last[elem / 100];
+	EXPECT_GT(elem, prev);
+	prev = elem;
+	++count;
+    }
+    EXPECT_EQ(count, 14 * 21 + 1);
+    for (auto i = 0; i < 100; ++i)
+	EXPECT_EQ(last[i], i % 7 ? 100 * i + i % 7 - 1 : -1);
+}
+
+TEST(CoroStream, ChooseWeighted)
+{
+    auto g = repeat(0) * repeat(1) * repeat(2) | choose({90, 9, 1}) | take(100000);
+    std::array<size_t, 3> counts{};
+    for (auto elem : g)
+	++counts[elem];
+    EXPECT_NEAR(counts[0], 90000, 1000);
+    EXPECT_NEAR(counts[1], 9000, 500);
+    EXPECT_NEAR(counts[2], 1000, 200);
+
+    std::vector<Generator<const int&>> sources;
+    sources.push_back(iota<int>(100));
+    sources.push_back(iota<int>(5, 100));
+    sources.push_back(iota<int>(0));
+    sources.push_back(iota<int>(5, 200));
+    auto c = std::move(sources) | choose({1, 1000, 1, 0}) | collect<std::vector>();
+    EXPECT_EQ(c.size(), 105);
+    std::sort(c.begin(), c.end());
+    for (auto i = 0; i < 105; ++i)
+	EXPECT_EQ(c[i], i);
+
+    EXPECT_THROW(std::vector<std::vector<int>>(2) | choose({1}) | collect<std::vector>(),
+		 std::runtime_error);
+}
+
 TEST(CoroStream, Collect)
 {
     auto vec = sampler<int>(0, 100) | take(4) | collect<std::vector>();
@@ -112,6 +208,63 @@ TEST(CoroStream, Collect)
     EXPECT_EQ(vec, vec_copy);
 }
 
+TEST(CoroStream, CollectSizeHint)
+{
+    auto hint = stream_size_hint(iota<int>(10));
+    EXPECT_TRUE(hint.exact);
+    EXPECT_EQ(hint.count, 10);
+
+    hint = stream_size_hint(iota<int>(10) | take(4));
+    EXPECT_TRUE(hint.exact);
+    EXPECT_EQ(hint.count, 4);
+
+    hint = stream_size_hint(sampler<int>(0, 100) | take(4));
+    EXPECT_FALSE(hint.exact);
+    EXPECT_EQ(hint.count, 4);
+
+    hint = stream_size_hint(iota<int>(10) | filter([](int n) { return n % 2; }));
+    EXPECT_FALSE(hint.exact);
+    EXPECT_EQ(hint.count, 10);
+
+    hint = stream_size_hint(sampler<int>(0, 100));
+    EXPECT_FALSE(hint.known());
+
+    std::vector<int> data{1, 2, 3};
+    hint = stream_size_hint(data | transform([](int n) { return n + 1; }) | fuse::take(2));
+    EXPECT_TRUE(hint.exact);
+    EXPECT_EQ(hint.count, 2);
+
+    auto vec = iota<int>(1000) | transform([](int n) { return 2 * n; }) | collect<std::vector>();
+    EXPECT_EQ(vec.size(), 1000);
+    EXPECT_EQ(vec.capacity(), 1000);
+}
+
+struct Counted {
+    Counted(int n) : value(n) { }
+    Counted(const Counted& other) : value(other.value) { ++copies; }
+    Counted(Counted&&) = default;
+    Counted& operator=(const Counted&) = default;
+    Counted& operator=(Counted&&) = default;
+    int value;
+    static inline size_t copies{0};
+};
+
+TEST(CoroStream, CollectMoves)
+{
+    auto vec = iota<int>(100)
+	| transform([](int n) { return Counted{n}; })
+	| collect<std::vector>();
+    EXPECT_EQ(vec.size(), 100);
+    EXPECT_EQ(Counted::copies, 0);
+
+    auto flat = iota<int>(100)
+	| transform([](int n) { return std::vector<Counted>(3, Counted{n}); })
+	| flatten<std::vector<Counted>>();
+    EXPECT_EQ(flat.size(), 300);
+    EXPECT_EQ(flat[299].value, 99);
+    EXPECT_EQ(Counted::copies, 300);
+}
+
 TEST(CoroStream, CollectFixedVector)
 {
     coro::detail::Fixed<std::vector<int>> data{1, 2, 3, 4};
@@ -119,6 +272,51 @@ TEST(CoroStream, CollectFixedVector)
     EXPECT_EQ(vec, data);
 }
 
+TEST(CoroStream, Contiguous)
+{
+    static_assert(ContiguousStream<std::vector<int>&>);
+    static_assert(ContiguousStream<const std::vector<int>&>);
+    static_assert(ContiguousStream<coro::detail::Fixed<std::vector<int>>>);
+    static_assert(RandomAccessStream<std::vector<bool>> and not ContiguousStream<std::vector<bool>>);
+    static_assert(not SizedStream<Generator<int>>);
+
+    const std::vector<int> data = iota<int>(100) | collect<std::vector>();
+    auto source = [&]() { return adapt(data); };
+    auto even = [](int n) { return n % 2 == 0; };
+    auto square = [](int n) { return n * n; };
+
+    EXPECT_EQ(data | take(10) | collect<std::vector>(), source() | take(10) | collect<std::vector>());
+    EXPECT_EQ(data | take(1000) | collect<std::vector>(), data);
+    EXPECT_EQ(data | filter(even) | collect<std::vector>(), source() | filter(even) | collect<std::vector>());
+    EXPECT_EQ(data | transform(square) | collect<std::vector>(),
+	      source() | transform(square) | collect<std::vector>());
+    EXPECT_EQ(data | collect<std::deque>(), source() | collect<std::deque>());
+
+    auto groups = data | group(30) | collect<std::vector>();
+    EXPECT_EQ(groups, source() | group(30) | collect<std::vector>());
+    EXPECT_EQ(groups.size(), 3);
+    auto owned = std::vector<std::string>{"a", "b", "c", "d", "e"} | group(2) | collect<std::vector>();
+    EXPECT_EQ(owned, (std::vector<std::vector<std::string>>{{"a", "b"}, {"c", "d"}, {"e"}}));
+
+    std::vector<int> other{5, 6, 7};
+    auto zipped = zip(data, other);
+    EXPECT_EQ(zipped.size_hint().count, 3);
+    EXPECT_EQ(zipped | collect<std::vector>(), (source() * adapt(other) | zip() | collect<std::vector>()));
+    EXPECT_EQ(zip(std::tuple{data, other}) | collect<std::vector>(),
+	      (std::vector<std::tuple<int, int>>{{0, 5}, {1, 6}, {2, 7}}));
+
+    for (auto n : draw(other) | take(NumberSamples))
+	EXPECT_TRUE(n >= 5 and n <= 7);
+    std::vector<int> empty;
+    EXPECT_TRUE((draw(empty) | collect<std::vector>()).empty());
+
+    // An owned source of the collected type is returned as is.
+    std::vector<int> moved{1, 2, 3};
+    auto ptr = moved.data();
+    auto collected = std::move(moved) | collect<std::vector>();
+    EXPECT_EQ(collected.data(), ptr);
+}
+
 TEST(CoroStream, Filter)
 {
     auto g = sampler<int>(0, 100) | filter([](int n) { return n % 2 == 0; }) | take(NumberSamples);
@@ -134,6 +332,53 @@ TEST(CoroStream, FilterFixedVector)
 	EXPECT_TRUE(elem % 2 == 0);
 }
 
+TEST(CoroStream, Fuse)
+{
+    auto square = [](int n) { return n * n; };
+    auto odd = [](int n) { return n % 2 == 1; };
+
+    auto expected = iota<int>(100) | transform(square) | filter(odd) | take(10) | collect<std::vector>();
+    auto fused = iota<int>(100) | fuse::transform(square) | fuse::filter(odd) | fuse::take(10);
+    EXPECT_EQ(std::move(fused) | collect<std::vector>(), expected);
+
+    auto sum = iota<int>(100) | fuse::transform(square) | fuse::filter(odd) | fuse::take(10)
+	| reduce(0, [](int& acc, int n) { acc += n; });
+    EXPECT_EQ(sum, std::accumulate(expected.begin(), expected.end(), 0));
+
+    // Materialized as a Generator when iterated or chained with an unfused operator.
+    std::vector<int> actual;
+    for (auto n : iota<int>(100) | fuse::transform(square) | fuse::filter(odd) | take(10))
+	actual.push_back(n);
+    EXPECT_EQ(actual, expected);
+
+    // Lvalue elements are passed through by reference.
+    std::vector<int> data{1, 2, 3, 4, 5, 6};
+    auto count = data | fuse::filter(odd) | apply([](int& n) { n = 0; });
+    EXPECT_EQ(count, 3);
+    EXPECT_EQ(data, (std::vector<int>{0, 2, 0, 4, 0, 6}));
+    for (auto& n : data | fuse::filter([](int n) { return n > 0; }))
+	n = -n;
+    EXPECT_EQ(data, (std::vector<int>{0, -2, 0, -4, 0, -6}));
+
+    // take stops without pulling further elements from the source.
+    size_t pulled{0};
+    auto first = iota<int>(100)
+	| transform([&](int n) { ++pulled; return n; })
+	| fuse::take(3)
+	| collect<std::vector>();
+    EXPECT_EQ(first.size(), 3);
+    EXPECT_EQ(pulled, 3);
+    EXPECT_EQ((iota<int>(10) | fuse::take(0) | collect<std::vector>()).size(), 0);
+
+    // Move-only results.
+    auto ptrs = iota<int>(5) | fuse::transform([](int n) { return std::make_unique<int>(n); })
+	| fuse::filter([](const std::unique_ptr<int>& p) { return *p % 2 == 0; });
+    std::vector<int> values;
+    for (auto&& p : ptrs)
+	values.push_back(*p);
+    EXPECT_EQ(values, (std::vector<int>{0, 2, 4}));
+}
+
 TEST(CoroStream, Group)
 {
     for (auto vec : sampler<int>(0, 100) | group(4) | take(NumberSamples)) {
@@ -155,6 +400,25 @@ TEST(CoroStream, Group)
     }
 }
 
+TEST(CoroStream, GroupSpan)
+{
+    std::vector<std::vector<int>> groups;
+    for (auto span : iota<int>(10) | group_span(4))
+	groups.emplace_back(span.begin(), span.end());
+    EXPECT_EQ(groups, (std::vector<std::vector<int>>{{0, 1, 2, 3}, {4, 5, 6, 7}, {8, 9}}));
+}
+
+TEST(CoroStream, GroupByBytes)
+{
+    std::vector<std::string> data{"aaa", "bb", "c", "dddddd", "ee", "f"};
+    std::vector<std::vector<std::string>> groups;
+    auto size = [](const std::string& s) { return s.size(); };
+    for (auto span : data | group_by_bytes(5, size))
+	groups.emplace_back(span.begin(), span.end());
+    EXPECT_EQ(groups, (std::vector<std::vector<std::string>>{
+		{"aaa", "bb"}, {"c"}, {"dddddd"}, {"ee", "f"}}));
+}
+
 TEST(CoroStream, GroupTuple)
 {
     for (auto [a, b] : sampler<int>(0, 100) | group_tuple<2>() | take(NumberSamples)) {
@@ -182,6 +446,49 @@ TEST(CoroStream, IotaStart)
 	EXPECT_EQ(c[i], i + 10);
 }
 
+TEST(CoroStream, Merge)
+{
+    std::vector<Generator<const int&>> sources;
+    for (auto i = 0; i < 7; ++i)
+	sources.push_back(iota<int>(10 + i, i, 7));
+    auto c = std::move(sources) | merge() | collect<std::vector>();
+    EXPECT_EQ(c.size(), 10 * 7 + 21);
+    EXPECT_TRUE(std::is_sorted(c.begin(), c.end()));
+    for (auto i = 0; i < 70; ++i)
+	EXPECT_EQ(c[i], i);
+
+    std::vector<int> evens{0, 2, 4, 6};
+    auto d = evens * iota<int>(3, 1, 2) | merge() | collect<std::vector>();
+    EXPECT_EQ(d, (std::vector<int>{0, 1, 2, 3, 4, 5, 6}));
+
+    auto e = std::vector<Generator<const int&>>{} | merge() | collect<std::vector>();
+    EXPECT_TRUE(e.empty());
+
+    auto words = [](std::vector<std::string_view> data) -> Generator<std::string_view> {
+	for (auto word : data)
+	    co_yield word;
+    };
+    auto f = words({"b", "d"}) * words({"a", "c", "e"}) | merge() | collect<std::vector>();
+    EXPECT_EQ(f, (std::vector<std::string_view>{"a", "b", "c", "d", "e"}));
+}
+
+TEST(CoroStream, MergeStable)
+{
+    using Pair = std::pair<int, int>;
+    std::vector<std::vector<Pair>> sources{
+	{ {0, 0}, {1, 0}, {1, 0}, {3, 0} },
+	{},
+	{ {1, 2}, {2, 2}, {3, 2} },
+	{ {0, 3}, {1, 3} }
+    };
+    auto by_first = [](const Pair& a, const Pair& b) { return a.first < b.first; };
+    auto c = std::move(sources) | merge(by_first) | collect<std::vector>();
+    std::vector<Pair> expected{
+	{0, 0}, {0, 3}, {1, 0}, {1, 0}, {1, 2}, {1, 3}, {2, 2}, {3, 0}, {3, 2}
+    };
+    EXPECT_EQ(c, expected);
+}
+
 TEST(CoroStream, Optionalize)
 {
     auto g = iota<int>(100) | optionalize(0.5);
@@ -194,6 +501,238 @@ TEST(CoroStream, Optionalize)
     EXPECT_LE(count, 75);
 }
 
+TEST(CoroStream, ParReduce)
+{
+    auto expected = iota<int>(10000) | transform([](int n) { return std::to_string(n); })
+	| reduce(std::string{}, [](std::string& acc, const std::string& s) { acc += s; });
+    for (auto batch : {1, 7, 4096}) {
+	auto actual = iota<int>(10000)
+	    | transform([](int n) { return std::to_string(n); })
+	    | par_reduce(std::string{},
+			 [](std::string& acc, const std::string& s) { acc += s; },
+			 [](std::string& acc, std::string&& other) { acc += other; },
+			 4, batch);
+	EXPECT_EQ(actual, expected);
+    }
+}
+
+TEST(CoroStream, ParReduceUnordered)
+{
+    auto sum = [](int64_t& acc, int n) { acc += n; };
+    auto combine = [](int64_t& acc, int64_t other) { acc += other; };
+    for (auto threads : {1, 4}) {
+	auto actual = iota<int>(100001) | par_reduce_unordered(int64_t{0}, sum, combine, threads, 64);
+	EXPECT_EQ(actual, int64_t{100000} * 100001 / 2);
+    }
+
+    std::vector<int> empty;
+    EXPECT_EQ(empty | par_reduce_unordered(int64_t{0}, sum, combine), 0);
+
+    auto throwing = [](int64_t& acc, int n) {
+	if (n == 5000)
+	    throw std::runtime_error("reduce failed");
+	acc += n;
+    };
+    EXPECT_THROW(iota<int>(100000) | par_reduce_unordered(int64_t{0}, throwing, combine, 4, 16),
+		 std::runtime_error);
+    EXPECT_THROW(iota<int>(100000) | par_reduce(int64_t{0}, throwing, combine, 4, 16),
+		 std::runtime_error);
+}
+
+TEST(CoroStream, ParTransform)
+{
+    auto expected = iota<int>(1000) | transform([](int n) { return n * n; }) | collect<std::vector>();
+    for (auto threads : {1, 2, 4}) {
+	for (auto window : {1, 3, 16}) {
+	    auto actual = iota<int>(1000)
+		| par_transform([](int n) { return n * n; }, threads, window)
+		| collect<std::vector>();
+	    EXPECT_EQ(actual, expected);
+	}
+    }
+
+    auto g = iota<int>(1000) | par_transform([](int n) { return n; }) | take(10);
+    EXPECT_EQ(g | collect<std::vector>(), iota<int>(10) | collect<std::vector>());
+}
+
+TEST(CoroStream, ParTransformUnordered)
+{
+    auto actual = iota<int>(1000)
+	| par_transform_unordered([](int n) { return std::make_unique<int>(n); }, 4, 8)
+	| transform([](const std::unique_ptr<int>& ptr) { return *ptr; })
+	| collect<std::vector>();
+    std::sort(actual.begin(), actual.end());
+    EXPECT_EQ(actual, iota<int>(1000) | collect<std::vector>());
+}
+
+TEST(CoroStream, ParTransformException)
+{
+    size_t count{0};
+    auto g = iota<int>(100) | par_transform([](int n) {
+	if (n == 10)
+	    throw std::runtime_error("transform failed");
+	return n;
+    }, 4, 8);
+    EXPECT_THROW(for (auto n : g) { EXPECT_EQ(n, count++); }, std::runtime_error);
+    EXPECT_EQ(count, 10);
+}
+
+TEST(CoroStream, Pipeline)
+{
+    auto expected = iota<int>(10000) | collect<std::vector>();
+    for (auto wait : {WaitStrategy::Spin, WaitStrategy::Yield, WaitStrategy::Block}) {
+	RingStats stats;
+	auto actual = iota<int>(10000)
+	    | pipeline({.capacity = 16, .wait = wait, .stats = &stats})
+	    | collect<std::vector>();
+	EXPECT_EQ(actual, expected);
+	EXPECT_EQ(stats.capacity, 16);
+	EXPECT_EQ(stats.produced, 10000);
+	EXPECT_EQ(stats.consumed, 10000);
+	EXPECT_EQ(stats.occupancy(), 0);
+    }
+}
+
+TEST(CoroStream, PipelineMultiStage)
+{
+    auto actual = iota<int>(1000)
+	| pipeline()
+	| transform([](int n) { return std::make_unique<int>(n); })
+	| pipeline({.capacity = 4, .wait = WaitStrategy::Block})
+	| transform([](const std::unique_ptr<int>& ptr) { return *ptr; })
+	| pipeline()
+	| collect<std::vector>();
+    EXPECT_EQ(actual, iota<int>(1000) | collect<std::vector>());
+}
+
+TEST(CoroStream, PipelineEarlyExit)
+{
+    for (auto wait : {WaitStrategy::Spin, WaitStrategy::Yield, WaitStrategy::Block}) {
+	auto actual = sampler<int>(0, 100)
+	    | pipeline({.capacity = 8, .wait = wait})
+	    | take(100)
+	    | collect<std::vector>();
+	EXPECT_EQ(actual.size(), 100);
+    }
+}
+
+Generator<int> throwing_source(int n) {
+    for (auto i = 0; i < n; ++i)
+	co_yield i;
+    throw std::runtime_error("source failed");
+}
+
+TEST(CoroStream, PipelineException)
+{
+    size_t count{0};
+    auto g = throwing_source(10) | pipeline();
+    EXPECT_THROW(for (auto n : g) { EXPECT_EQ(n, count++); }, std::runtime_error);
+    EXPECT_EQ(count, 10);
+}
+
+TEST(CoroStream, Prefetch)
+{
+    auto expected = iota<int>(10000) | collect<std::vector>();
+    for (auto wait : {WaitStrategy::Spin, WaitStrategy::Yield, WaitStrategy::Block}) {
+	PrefetchStats stats;
+	auto actual = iota<int>(10000)
+	    | prefetch({.capacity = 16, .max_capacity = 64, .wait = wait, .stats = &stats})
+	    | collect<std::vector>();
+	EXPECT_EQ(actual, expected);
+	EXPECT_EQ(stats.capacity, 64);
+	EXPECT_GE(stats.limit, 16);
+	EXPECT_LE(stats.limit, 64);
+	EXPECT_EQ(stats.produced, 10000);
+	EXPECT_EQ(stats.consumed, 10000);
+	EXPECT_EQ(stats.occupancy(), 0);
+    }
+
+    auto actual = iota<int>(1000) | prefetch(4) | collect<std::vector>();
+    EXPECT_EQ(actual, iota<int>(1000) | collect<std::vector>());
+}
+
+TEST(CoroStream, PrefetchMoveOnly)
+{
+    auto actual = iota<int>(1000)
+	| transform([](int n) { return std::make_unique<int>(n); })
+	| prefetch(8)
+	| transform([](const std::unique_ptr<int>& ptr) { return *ptr; })
+	| collect<std::vector>();
+    EXPECT_EQ(actual, iota<int>(1000) | collect<std::vector>());
+}
+
+TEST(CoroStream, PrefetchEarlyExit)
+{
+    for (auto wait : {WaitStrategy::Spin, WaitStrategy::Yield, WaitStrategy::Block}) {
+	auto actual = sampler<int>(0, 100)
+	    | prefetch({.capacity = 8, .wait = wait})
+	    | take(100)
+	    | collect<std::vector>();
+	EXPECT_EQ(actual.size(), 100);
+    }
+}
+
+TEST(CoroStream, PrefetchException)
+{
+    size_t count{0};
+    auto g = throwing_source(10) | prefetch(4);
+    EXPECT_THROW(for (auto n : g) { EXPECT_EQ(n, count++); }, std::runtime_error);
+    EXPECT_EQ(count, 10);
+}
+
+TEST(CoroStream, PrefetchBytes)
+{
+    // With a budget of 100 bytes no more than ten 10-byte strings are
+    // ever buffered.
+    PrefetchStats stats;
+    size_t count{0};
+    auto g = iota<int>(1000)
+	| transform([](int) { return std::string(10, 'x'); })
+	| prefetch_bytes(100, [](const std::string& s) { return s.size(); },
+			 {.adaptive = false, .stats = &stats});
+    for (auto&& s : g) {
+	EXPECT_EQ(s.size(), 10);
+	EXPECT_LE(stats.occupancy(), 10);
+	++count;
+    }
+    EXPECT_EQ(count, 1000);
+    EXPECT_EQ(stats.bytes, 100);
+    EXPECT_EQ(stats.resizes, 0);
+
+    // An element larger than the budget is still admitted on its own.
+    auto actual = iota<int>(10)
+	| transform([](int n) { return std::string(1000, 'a' + n); })
+	| prefetch_bytes(100, [](const std::string& s) { return s.size(); })
+	| collect<std::vector>();
+    ASSERT_EQ(actual.size(), 10);
+    EXPECT_EQ(actual[9], std::string(1000, 'j'));
+}
+
+TEST(CoroStream, PrefetchAdaptive)
+{
+    // A producer that pauses between bursts and a consumer that is
+    // slower than a burst both stall, so the buffer grows.
+    PrefetchStats stats;
+    auto g = iota<int>(2000)
+	| transform([](int n) {
+	    if (n % 100 == 99)
+		std::this_thread::sleep_for(std::chrono::milliseconds(2));
+	    return n;
+	})
+	| prefetch({.capacity = 2, .max_capacity = 64, .stats = &stats});
+    int expected{0};
+    for (auto n : g) {
+	EXPECT_EQ(n, expected++);
+	std::this_thread::sleep_for(std::chrono::microseconds(10));
+    }
+    EXPECT_EQ(expected, 2000);
+    EXPECT_GT(stats.full_waits, 0);
+    EXPECT_GT(stats.empty_waits, 0);
+    EXPECT_GT(stats.resizes, 0);
+    EXPECT_GT(stats.limit, 2);
+    EXPECT_LE(stats.limit, 64);
+}
+
 TEST(CoroStream, Range)
 {
     auto c = range(10, 14, 2) | collect<std::vector>();
@@ -260,6 +799,16 @@ TEST(CoroStream, SequenceFixedVector)
     EXPECT_EQ(count, 30);
 }
 
+TEST(CoroStream, SequenceVector)
+{
+    std::vector<std::vector<int>> sources{ {0, 1, 2}, {}, {3}, {4, 5} };
+    auto g = std::move(sources) | sequence();
+    EXPECT_EQ(stream_size_hint(g).count, 6);
+    EXPECT_TRUE(stream_size_hint(g).exact);
+    auto c = std::move(g) | collect<std::vector>();
+    EXPECT_EQ(c, (std::vector<int>{0, 1, 2, 3, 4, 5}));
+}
+
 TEST(CoroStream, Take)
 {
     auto g = iota<int>(99) | take(5);
@@ -327,6 +876,55 @@ TEST(CoroStream, UniqueFixedVector)
     EXPECT_EQ(s.size(), 3);
 }
 
+TEST(CoroStream, UniqueIdentity)
+{
+    std::vector<int> data{3, 1, 3, 2, 1, 3};
+    auto actual = data | unique() | collect<std::vector>();
+    EXPECT_EQ(actual, (std::vector<int>{3, 1, 2}));
+
+    struct Hash {
+	size_t operator()(int) const { return 0; }
+    };
+    std::vector<int> twice;
+    for (auto i = 0; i < 2000; ++i)
+	twice.push_back(i % 1000);
+    auto colliding = twice | unique(detail::Identity{}, Hash{}) | collect<std::vector>();
+    EXPECT_EQ(colliding.size(), 1000);
+}
+
+TEST(CoroStream, UniqueOrderedKey)
+{
+    // std::pair has no std::hash, so its keys are kept ordered.
+    std::vector<int> data{1, 2, 11, 3, 12, 21, 22, 4};
+    auto actual = data
+	| unique([](int n) { return std::make_pair(n / 10, n % 2); })
+	| collect<std::vector>();
+    EXPECT_EQ(actual, (std::vector<int>{1, 2, 11, 12, 21, 22}));
+}
+
+TEST(CoroStream, UniqueLru)
+{
+    std::vector<int> data{1, 2, 1, 3, 1, 2, 4, 2};
+    // Capacity 2: 1, 2, (1), 3 evicts 2, (1), 2 evicts 3, 4 evicts 1, (2)
+    auto actual = data | unique_lru([](int n) { return n; }, 2) | collect<std::vector>();
+    EXPECT_EQ(actual, (std::vector<int>{1, 2, 3, 2, 4}));
+
+    auto all = iota<int>(10000) | unique_lru([](int n) { return n % 100; }, 100) | collect<std::vector>();
+    EXPECT_EQ(all.size(), 100);
+}
+
+TEST(CoroStream, UniqueBloom)
+{
+    auto actual = iota<int>(20000)
+	| unique_bloom([](int n) { return n % 10000; }, {.expected = 10000, .false_positive = 0.01})
+	| collect<std::vector>();
+    std::set<int> keys;
+    for (auto n : actual)
+	EXPECT_TRUE(keys.insert(n % 10000).second);
+    EXPECT_GT(actual.size(), 9800);
+    EXPECT_LE(actual.size(), 10000);
+}
+
 TEST(CoroStream, Zip)
 {
     auto g = sampler<int>(-20, +20)
@@ -364,6 +962,45 @@ TEST(CoroStream, ZipFixedVector)
     EXPECT_EQ(count, 3);
 }
 
+TEST(CoroStream, ZipColumns)
+{
+    std::vector<int> a = iota<int>(10) | collect<std::vector>();
+    const std::vector<double> b = iota<int>(8) | transform([](int n) { return n / 2.0; }) | collect<std::vector>();
+
+    // Contiguous columns are viewed in place.
+    auto g = zip_columns(3, a, b);
+    EXPECT_EQ(g.size_hint().count, 3);
+    std::vector<size_t> sizes;
+    for (auto [x, y] : g) {
+	static_assert(std::is_same_v<decltype(x), std::span<const int>>);
+	static_assert(std::is_same_v<decltype(y), std::span<const double>>);
+	EXPECT_EQ(x.data(), a.data() + 3 * sizes.size());
+	EXPECT_EQ(y.data(), b.data() + 3 * sizes.size());
+	sizes.push_back(x.size());
+    }
+    EXPECT_EQ(sizes, (std::vector<size_t>{3, 3, 2}));
+
+    // Other sources are buffered and must agree with zip.
+    auto expected = iota<int>(10) * iota<int>(7) | zip() | collect<std::vector>();
+    std::vector<std::tuple<int, int>> rows;
+    for (auto [x, y] : iota<int>(10) * iota<int>(7) | zip_columns(4)) {
+	static_assert(std::is_same_v<decltype(x), std::span<int>>);
+	EXPECT_EQ(x.size(), y.size());
+	for (size_t i = 0; i < x.size(); ++i)
+	    rows.emplace_back(x[i], y[i]);
+    }
+    EXPECT_EQ(rows, expected);
+
+    int total{0};
+    a * iota<int>(100) | zip_columns() | apply([&](auto columns) {
+	auto [x, y] = columns;
+	for (size_t i = 0; i < x.size(); ++i)
+	    total += x[i] * y[i];
+    });
+    EXPECT_EQ(total, 285);
+    EXPECT_THROW(zip_columns(0, a), std::runtime_error);
+}
+
 int main(int argc, char *argv[])
 {
     ::testing::InitGoogleTest(&argc, argv);
@@ -2,11 +2,33 @@
 //
 
 #include <gtest/gtest.h>
+#include <cstdlib>
+#include <optional>
+#include <thread>
 #include "coro/stream/generator.h"
 #include "coro/stream/stream.h"
 
 static const size_t NumberSamples = 2;
 
+// Count every call to the global allocator so that frame reuse can be
+// observed.
+static size_t gs_allocations{0};
+
+void *operator new(std::size_t size) {
+    ++gs_allocations;
+    if (auto ptr = std::malloc(size))
+	return ptr;
+    throw std::bad_alloc{};
+}
+
+void operator delete(void *ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void *ptr, std::size_t) noexcept {
+    std::free(ptr);
+}
+
 coro::Generator<int> iota(size_t n) {
     for (auto i = 0; i < n; ++i)
 	co_yield i;
@@ -61,6 +83,159 @@ TEST(CoroGenerator, RecursiveFibonacci)
     }
 }
 
+coro::Generator<int> throwing_counter(int n, int fail) {
+    if (n > 0)
+	co_yield throwing_counter(n - 1, fail);
+    if (n == fail)
+	throw std::runtime_error("fail");
+    co_yield n;
+}
+
+TEST(CoroGenerator, RecursiveException)
+{
+    for (auto fail : { 0, 5, 100 }) {
+	int count{0};
+	try {
+	    for (auto n : throwing_counter(100, fail))
+		EXPECT_EQ(count++, n);
+	    FAIL() << "expected an exception";
+	} catch (const std::runtime_error& e) {
+	    EXPECT_STREQ(e.what(), "fail");
+	}
+	EXPECT_EQ(count, fail);
+	EXPECT_EQ(coro::detail::pending_exception(), nullptr);
+    }
+
+    size_t count{0};
+    for (auto i : recursive_counter(100))
+	EXPECT_EQ(count++, i);
+    EXPECT_EQ(count, 101);
+}
+
+template<class T>
+struct counting_allocator {
+    using value_type = T;
+
+    counting_allocator(size_t *count) : count_(count) { }
+
+    template<class U>
+    counting_allocator(const counting_allocator<U>& other) : count_(other.count_) { }
+
+    T *allocate(size_t n) {
+	++*count_;
+	return std::allocator<T>{}.allocate(n);
+    }
+
+    void deallocate(T *ptr, size_t n) {
+	--*count_;
+	std::allocator<T>{}.deallocate(ptr, n);
+    }
+
+    size_t *count_;
+};
+
+coro::Generator<int> allocated_iota(std::allocator_arg_t, counting_allocator<int>, int n) {
+    for (auto i = 0; i < n; ++i)
+	co_yield i;
+}
+
+TEST(CoroGenerator, Allocator)
+{
+    size_t live{0};
+    {
+	auto g = allocated_iota(std::allocator_arg, counting_allocator<int>{&live}, 5);
+	EXPECT_EQ(live, 1);
+	size_t count{0};
+	for (auto n : g)
+	    EXPECT_EQ(count++, n);
+	EXPECT_EQ(count, 5);
+    }
+    EXPECT_EQ(live, 0);
+}
+
+TEST(CoroGenerator, FramePoolReuse)
+{
+    auto chain = []() {
+	auto g = iota(10) | coro::filter([](int n) { return n % 2 == 0; }) | coro::take(3);
+	int sum{0};
+	for (auto n : g)
+	    sum += n;
+	return sum;
+    };
+
+    // The first chain populates the pool; later chains reuse its
+    // three frames without touching the global allocator.
+    EXPECT_EQ(chain(), 6);
+    auto start = gs_allocations;
+    int sum{0};
+    for (auto i = 0; i < 1000; ++i)
+	sum += chain();
+    auto allocations = gs_allocations - start;
+    EXPECT_EQ(sum, 6000);
+#if CORO_STREAM_FRAME_POOL
+    EXPECT_EQ(allocations, 0);
+#else
+    EXPECT_GE(allocations, 3000);
+#endif
+}
+
+TEST(CoroGenerator, ScopedFrames)
+{
+    auto chain = []() {
+	return iota(100)
+	    | coro::filter([](int n) { return n % 2 == 0; })
+	    | coro::transform([](int n) { return n * n; })
+	    | coro::reduce(0, [](int& acc, int n) { acc += n; });
+    };
+    auto expected = chain();
+
+    coro::ScopedFrames<4096> frames;
+    for (auto i = 0; i < 100; ++i)
+	EXPECT_EQ(chain(), expected);
+    EXPECT_GT(frames.high_water(), 0);
+    EXPECT_LE(frames.high_water(), 4096);
+    EXPECT_EQ(frames.fallbacks(), 0);
+
+    // Frames that do not fit fall back to the pool.
+    {
+	coro::ScopedFrames<256> small;
+	EXPECT_EQ(chain(), expected);
+	EXPECT_GT(small.fallbacks(), 0);
+    }
+
+    auto sum = coro::scoped([&]() { return chain(); });
+    EXPECT_EQ(sum, expected);
+    auto evens = coro::scoped<1024>([]() {
+	return iota(10) | coro::filter([](int n) { return n % 2 == 0; }) | coro::collect<std::vector>();
+    });
+    EXPECT_EQ(evens, (std::vector<int>{0, 2, 4, 6, 8}));
+}
+
+TEST(CoroGenerator, ScopedFramesLifetime)
+{
+    // A frame released on another thread is counted without touching
+    // the buffer.
+    {
+	coro::ScopedFrames<4096> frames;
+	auto g = iota(10);
+	std::thread([g = std::move(g)]() mutable {
+	    int sum{0};
+	    for (auto n : g)
+		sum += n;
+	    EXPECT_EQ(sum, 45);
+	}).join();
+    }
+
+    // A frame outliving its scope aborts.
+    EXPECT_DEATH({
+	    std::optional<coro::Generator<int>> g;
+	    {
+		coro::ScopedFrames<4096> frames;
+		g.emplace(iota(10));
+	    }
+	}, "outlives its scope");
+}
+
 TEST(CoroGenerator, Ranges)
 {
     // auto g = counter(20) | v::take(5);
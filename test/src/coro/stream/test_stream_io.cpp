@@ -1,9 +1,15 @@
 // Copyright 2021, 2022, 2024 by Mark Melton
 //
 
+#include <fcntl.h>
 #include <filesystem>
 #include <fmt/format.h>
 #include <gtest/gtest.h>
+#include <unistd.h>
+#if defined(__linux__) && __has_include(<linux/io_uring.h>)
+#include <linux/io_uring.h>
+#include <sys/syscall.h>
+#endif
 
 #include "coro/stream/detail/fixed.h"
 #include "coro/stream/io/generator_istream.h"
@@ -54,6 +60,143 @@ TEST(CoroStreamIo, PlainFile) {
     }
 }
 
+TEST(CoroStreamIo, MergeFiles) {
+    // Sorted shards read as Generator<std::string&&> merge into one
+    // sorted stream.
+    std::vector<std::string> expected, files;
+    std::vector<Generator<std::string&&>> shards;
+    for (auto i = 0; i < 3; ++i) {
+        auto lines = env->get_sample();
+        std::sort(lines.begin(), lines.end());
+        files.push_back(env->get_filename(fmt::format("shard{}.dat", i)));
+        write_lines_plain(lines, files.back());
+        expected.insert(expected.end(), lines.begin(), lines.end());
+    }
+    for (const auto& fn : files)
+        shards.push_back(read_lines_plain(fn));
+    std::sort(expected.begin(), expected.end());
+    auto actual = std::move(shards) | merge() | collect<std::vector>();
+    EXPECT_EQ(actual, expected);
+}
+
+TEST(CoroStreamIo, MmapFile) {
+    for (auto i = 0; i < NumberSamples; ++i) {
+        auto expected = env->get_sample();
+        auto fn = env->get_filename("mmap.dat");
+        write_lines_plain(expected, fn);
+        std::vector<std::string> actual;
+        for (auto line : read_lines_mmap(fn))
+            actual.emplace_back(line);
+        EXPECT_EQ(actual, expected);
+    }
+}
+
+TEST(CoroStreamIo, MmapFileEdges) {
+    auto fn = env->get_filename("edges.dat");
+    std::ofstream{fn} << "";
+    EXPECT_EQ((read_lines_mmap(fn) | collect<std::vector>()).size(), 0);
+
+    std::ofstream{fn} << "abc\n\ndef";
+    std::vector<std::string> lines;
+    for (auto line : read_lines_mmap(fn))
+        lines.emplace_back(line);
+    EXPECT_EQ(lines, (std::vector<std::string>{"abc", "", "def"}));
+
+    EXPECT_THROW(read_lines_mmap(env->get_filename("missing.dat")).begin(), std::runtime_error);
+}
+
+TEST(CoroStreamIo, BufferedFile) {
+    for (auto buffer_bytes : {1, 16, 1 << 20}) {
+        for (auto flush_lines : {0, 1, 3}) {
+            auto expected = env->get_sample();
+            auto fn = env->get_filename("buffered.dat");
+            WriteOptions options{.buffer_bytes = size_t(buffer_bytes),
+                                 .flush_lines = size_t(flush_lines)};
+            auto stats = write_lines_file(expected, fn, options);
+            auto actual = read_lines_plain(fn) | collect<std::vector>();
+            EXPECT_EQ(actual, expected);
+            EXPECT_EQ(stats.lines, expected.size());
+            EXPECT_EQ(stats.bytes, fs::file_size(fn));
+        }
+    }
+}
+
+TEST(CoroStreamIo, BufferedFd) {
+    auto expected = env->get_sample();
+    auto fn = env->get_filename("fd.dat");
+    auto fd = ::open(fn.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    ASSERT_GE(fd, 0);
+    auto stats = expected | write_lines_fd(fd, {.buffer_bytes = 64});
+    ::close(fd);
+    EXPECT_EQ(stats.lines, expected.size());
+    auto actual = read_lines_plain(fn) | collect<std::vector>();
+    EXPECT_EQ(actual, expected);
+}
+
+TEST(CoroStreamIo, UringFile) {
+    for (auto uring : {true, false}) {
+        for (auto block_bytes : {1, 7, 1 << 20}) {
+            auto expected = env->get_sample();
+            auto fn = env->get_filename("uring.dat");
+            AsyncOptions options{.block_bytes = size_t(block_bytes), .depth = 2, .uring = uring};
+            auto stats = expected | write_lines_uring(fn, options);
+            EXPECT_EQ(stats.lines, expected.size());
+            EXPECT_EQ(stats.bytes, fs::file_size(fn));
+            std::vector<std::string> actual;
+            for (auto line : read_lines_uring(fn, options))
+                actual.emplace_back(line);
+            EXPECT_EQ(actual, expected);
+        }
+    }
+}
+
+// Return true iff the kernel lets this process create an io_uring.
+static bool uring_available() {
+#if defined(__linux__) && __has_include(<linux/io_uring.h>)
+    io_uring_params params{};
+    int fd = ::syscall(__NR_io_uring_setup, 2u, &params);
+    if (fd < 0)
+        return false;
+    ::close(fd);
+    return true;
+#else
+    return false;
+#endif
+}
+
+TEST(CoroStreamIo, UringBackend) {
+    auto fn = env->get_filename("uring-backend.dat");
+    for (auto uring : {true, false}) {
+        AsyncOptions options{.depth = 2, .uring = uring};
+        auto expected = uring and uring_available();
+        {
+            detail::BlockWriter writer{fn, options};
+            EXPECT_EQ(writer.uring(), expected);
+            writer.write_line("line");
+            writer.finish();
+        }
+        detail::BlockReader reader{fn, options};
+        EXPECT_EQ(reader.uring(), expected);
+        EXPECT_EQ(reader.next(), "line\n");
+    }
+}
+
+TEST(CoroStreamIo, UringFileEdges) {
+    auto fn = env->get_filename("uring-edges.dat");
+    std::ofstream{fn} << "";
+    EXPECT_EQ((read_lines_uring(fn) | collect<std::vector>()).size(), 0);
+
+    std::ofstream{fn} << "abc\n\ndef";
+    for (auto block_bytes : {1, 2, 64}) {
+        std::vector<std::string> lines;
+        for (auto line : read_lines_uring(fn, {.block_bytes = size_t(block_bytes)}))
+            lines.emplace_back(line);
+        EXPECT_EQ(lines, (std::vector<std::string>{"abc", "", "def"}));
+    }
+
+    EXPECT_THROW(read_lines_uring(env->get_filename("missing.dat")), std::runtime_error);
+}
+
 struct ioable {
     void write(const char *data, size_t size) {
         if (size != 1 or data[0] != '\n')
@@ -3,8 +3,12 @@
 
 #include <bit>
 #include <deque>
+#include <filesystem>
+#include <fstream>
 #include <gtest/gtest.h>
 #include <limits>
+#include <set>
+#include <thread>
 
 #include "core/mp/foreach.h"
 #include "coro/stream/stream.h"
@@ -391,6 +395,269 @@ TEST(CoroStream, Tuple) {
     }
 }
 
+template<class E>
+void check_engine() {
+    E a{42}, b{42}, c{42, 1};
+    std::vector<uint64_t> va, vc;
+    for (auto i = 0; i < NumberSamples; ++i) {
+        va.push_back(a());
+        vc.push_back(c());
+        EXPECT_EQ(va.back(), b());
+    }
+    EXPECT_NE(va, vc);
+
+    E d{7}, e{7};
+    for (auto i = 0; i < 1001; ++i)
+        d();
+    e.discard(1001);
+    for (auto i = 0; i < NumberSamples; ++i)
+        EXPECT_EQ(d(), e());
+}
+
+TEST(CoroStream, Engines) {
+    check_engine<SplitMix64>();
+    check_engine<Xoshiro256ss>();
+    check_engine<Pcg64>();
+    check_engine<Philox4x64>();
+
+    Xoshiro256ss x{42}, y{42};
+    y.jump();
+    EXPECT_NE(x(), y());
+}
+
+TEST(CoroStream, SeedRng) {
+    seed_rng(1234);
+    auto expected = sampler<uint64_t>() | take(NumberSamples) | collect<std::vector>();
+    seed_rng(1234);
+    auto actual = sampler<uint64_t>() | take(NumberSamples) | collect<std::vector>();
+    EXPECT_EQ(actual, expected);
+
+    std::vector<uint64_t> other;
+    std::thread thread{[&]() {
+        other = sampler<uint64_t>() | take(NumberSamples) | collect<std::vector>();
+    }};
+    thread.join();
+    EXPECT_NE(other, expected);
+}
+
+TEST(CoroStream, Fill) {
+    std::vector<int> ints(1001);
+    Sampler<int>{}.fill(ints, -3, 3);
+    std::set<int> seen(ints.begin(), ints.end());
+    EXPECT_EQ(seen, (std::set<int>{-3, -2, -1, 0, 1, 2, 3}));
+
+    std::vector<uint64_t> words(1001);
+    sample_fill<uint64_t>(std::span{words});
+    EXPECT_NE(words[0], words[1]);
+
+    std::vector<uint8_t> bytes(1001);
+    sample_fill<uint8_t>(std::span{bytes}, 10, 11);
+    for (auto b : bytes)
+        EXPECT_TRUE(b == 10 or b == 11);
+
+    // Narrow signed types with a negative minimum.
+    std::vector<int8_t> tiny(1001);
+    Sampler<int8_t>{}.fill(tiny, -3, 3);
+    EXPECT_EQ(std::set<int8_t>(tiny.begin(), tiny.end()), (std::set<int8_t>{-3, -2, -1, 0, 1, 2, 3}));
+
+    std::vector<int16_t> shorts(1001);
+    Sampler<int16_t>{}.fill(shorts, -10, 10);
+    for (auto n : shorts) {
+        EXPECT_GE(n, -10);
+        EXPECT_LE(n, 10);
+    }
+    EXPECT_EQ(std::set<int16_t>(shorts.begin(), shorts.end()).size(), 21);
+
+    // Full ranges.
+    Sampler<int8_t>{}.fill(tiny);
+    EXPECT_GT(std::set<int8_t>(tiny.begin(), tiny.end()).size(), 200);
+    Sampler<int16_t>{}.fill(shorts);
+    EXPECT_GT(std::set<int16_t>(shorts.begin(), shorts.end()).size(), 900);
+    std::vector<int64_t> longs(1001);
+    Sampler<int64_t>{}.fill(longs);
+    EXPECT_GT(std::set<int64_t>(longs.begin(), longs.end()).size(), 1000);
+
+    // 128-bit types draw both words.
+    std::vector<__uint128_t> wide(1001);
+    Sampler<__uint128_t>{}.fill(wide);
+    std::set<uint64_t> highs;
+    for (auto n : wide)
+        highs.insert(uint64_t(n >> 64));
+    EXPECT_GT(highs.size(), 1000);
+
+    __int128 lo = -(__int128{1} << 100), hi = __int128{1} << 100;
+    std::vector<__int128> signed_wide(1001);
+    Sampler<__int128>{}.fill(signed_wide, lo, hi);
+    size_t negative{0};
+    for (auto n : signed_wide) {
+        EXPECT_TRUE(n >= lo and n <= hi);
+        negative += n < 0;
+    }
+    EXPECT_GT(negative, 400);
+    EXPECT_LT(negative, 600);
+
+    Sampler<__uint128_t>{}.fill(wide, 5, 7);
+    for (auto n : wide)
+        EXPECT_TRUE(n >= 5 and n <= 7);
+
+    std::vector<double> reals(1001);
+    Sampler<double>{}.fill(reals, -1.0, 1.0);
+    for (auto x : reals) {
+        EXPECT_GE(x, -1.0);
+        EXPECT_LE(x, 1.0);
+    }
+
+    std::vector<float> floats(1001);
+    Sampler<float>{}.fill(floats, 0.0f, 1.0f);
+    for (auto x : floats) {
+        EXPECT_GE(x, 0.0f);
+        EXPECT_LE(x, 1.0f);
+    }
+
+    size_t count{0};
+    for (auto chunk : chunk::sampler<int>(64, 0, 9) | take(4)) {
+        EXPECT_EQ(chunk.size(), 64);
+        for (auto n : chunk) {
+            EXPECT_GE(n, 0);
+            EXPECT_LE(n, 9);
+            ++count;
+        }
+    }
+    EXPECT_EQ(count, 256);
+    EXPECT_THROW(Sampler<int>{}.chunked(0), std::runtime_error);
+    EXPECT_THROW(Sampler<double>{}.chunked(0), std::runtime_error);
+    EXPECT_THROW(chunk::sampler<int>(0, 0, 9), std::runtime_error);
+    EXPECT_THROW(chunk::sampler<double>(0, dist::Exponential{}), std::runtime_error);
+
+    seed_rng(99);
+    Sampler<uint64_t>{}.fill(std::span{words}.first(13));
+    auto expected = words;
+    seed_rng(99);
+    Sampler<uint64_t>{}.fill(std::span{words}.first(13));
+    EXPECT_EQ(words, expected);
+}
+
+// Return the mean and variance of `values`.
+static std::pair<double, double> moments(const std::vector<double>& values) {
+    double sum{0}, sum2{0};
+    for (auto x : values) {
+        sum += x;
+        sum2 += x * x;
+    }
+    auto mean = sum / values.size();
+    return { mean, sum2 / values.size() - mean * mean };
+}
+
+TEST(CoroStream, Distributions) {
+    constexpr size_t N = 200000;
+    std::vector<double> values(N);
+
+    sample_fill<double>(std::span{values}, dist::Normal{5.0, 2.0});
+    auto [normal_mean, normal_var] = moments(values);
+    EXPECT_NEAR(normal_mean, 5.0, 0.03);
+    EXPECT_NEAR(normal_var, 4.0, 0.06);
+    auto beyond = std::count_if(values.begin(), values.end(),
+                                [](double x) { return std::abs(x - 5.0) > 6.0; });
+    EXPECT_NEAR(double(beyond) / N, 0.0027, 0.0006);
+
+    sample_fill<double>(std::span{values}, dist::Exponential{4.0});
+    auto [exp_mean, exp_var] = moments(values);
+    EXPECT_NEAR(exp_mean, 0.25, 0.005);
+    EXPECT_NEAR(exp_var, 0.0625, 0.003);
+    EXPECT_THROW(dist::Exponential{0.0}, std::runtime_error);
+    EXPECT_THROW(dist::Exponential{std::nan("")}, std::runtime_error);
+
+    for (auto mean : {0.5, 3.0, 50.0, 1e4}) {
+        sample_fill<double>(std::span{values}, dist::Poisson{mean});
+        auto [m, v] = moments(values);
+        EXPECT_NEAR(m, mean, 5 * std::sqrt(mean / N));
+        EXPECT_NEAR(v, mean, 0.03 * mean);
+    }
+
+    std::array<double, 11> pmf{}, counts{};
+    double norm{0};
+    for (size_t k = 1; k <= 10; ++k)
+        norm += pmf[k] = std::pow(k, -1.2);
+    for (auto k : sampler<int>(dist::Zipf{10, 1.2}) | take(N)) {
+        ASSERT_GE(k, 1);
+        ASSERT_LE(k, 10);
+        ++counts[k];
+    }
+    for (size_t k = 1; k <= 10; ++k)
+        EXPECT_NEAR(counts[k] / N, pmf[k] / norm, 0.005);
+    for (auto k : sampler<uint64_t>(dist::Zipf{1'000'000'000, 0.8}) | take(1000))
+        EXPECT_TRUE(k >= 1 and k <= 1'000'000'000);
+
+    auto file = std::filesystem::temp_directory_path() / "coro_stream_empirical.txt";
+    {
+        std::ofstream ofs{file};
+        ofs << "# value weight\n1.5 3\n\n2.5\n  -1 0\n";
+    }
+    auto empirical = dist::Empirical::load(file.string());
+    std::filesystem::remove(file);
+    EXPECT_EQ(empirical.values(), (std::vector<double>{1.5, 2.5, -1}));
+    sample_fill<double>(std::span{values}, empirical);
+    EXPECT_EQ(std::count(values.begin(), values.end(), -1.0), 0);
+    EXPECT_NEAR(std::count(values.begin(), values.end(), 1.5) / double(N), 0.75, 0.01);
+
+    for (auto n : sampler<int>(std::binomial_distribution<int>(10, 0.5)) | take(100))
+        EXPECT_TRUE(n >= 0 and n <= 10);
+
+    size_t count{0};
+    for (auto chunk : chunk::sampler<double>(64, dist::Exponential{}) | take(4))
+        for (auto x : chunk)
+            count += x >= 0;
+    EXPECT_EQ(count, 256);
+}
+
+TEST(CoroStream, SamplerContext) {
+    SamplerContext ctx{42};
+    auto draw = [&](size_t index) {
+        auto ints = sampler<int>(ctx.substream(index), 0, 1000) | take(100) | collect<std::vector>();
+        auto reals = sampler<double>(ctx.substream(index), dist::Normal{}) | take(100) | collect<std::vector>();
+        auto strings = with_substream(ctx.substream(index), str::alpha(0, 8)) | take(10) | collect<std::vector>();
+        return std::tuple{ints, reals, strings};
+    };
+
+    // Each substream is reproducible and unaffected by the draws of
+    // the thread's own engine in between.
+    auto first = draw(0);
+    sampler<int>() | take(10) | collect<std::vector>();
+    EXPECT_EQ(draw(0), first);
+    EXPECT_NE(draw(1), first);
+    EXPECT_NE(SamplerContext{43}.substream(0).seed, ctx.substream(0).seed);
+    EXPECT_NE(ctx.split(0).seed(), ctx.split(1).seed());
+
+    // The same substreams drawn on one thread or spread over several.
+    constexpr size_t Substreams = 8;
+    using Draw = decltype(first);
+    std::vector<Draw> serial(Substreams), parallel(Substreams);
+    for (size_t i = 0; i < Substreams; ++i)
+        serial[i] = draw(i);
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < 4; ++t)
+        threads.emplace_back([&, t]() {
+            for (size_t i = t; i < Substreams; i += 4)
+                parallel[i] = draw(i);
+        });
+    for (auto& thread : threads)
+        thread.join();
+    EXPECT_EQ(serial, parallel);
+
+    // A generator resumed alternately with another keeps its sequence.
+    auto a = sampler<uint64_t>(ctx.substream(3));
+    auto b = sampler<uint64_t>(ctx.substream(4));
+    std::vector<uint64_t> interleaved;
+    for (auto [x, y] : a * b | zip() | take(50))
+        interleaved.push_back(x);
+    EXPECT_EQ(interleaved, sampler<uint64_t>(ctx.substream(3)) | take(50) | collect<std::vector>());
+
+    size_t count{0};
+    for (auto chunk : chunk::sampler<int>(16, ctx.substream(5), 0, 9) | take(2))
+        count += chunk.size();
+    EXPECT_EQ(count, 32);
+}
+
 int main(int argc, char *argv[]) {
     ::testing::InitGoogleTest(&argc, argv);
     return RUN_ALL_TESTS();